@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/gpio.h"
+#include "hardware/vreg.h"
+
+#include "dvi.h"
+#include "dvi_serialiser.h"
+#include "common_dvi_pin_configs.h"
+#include "rle_colour_decompress.h"
+
+// Clip from video/rle_colour_compress.py, with --width 1280
+#define MOVIE_BASE (XIP_BASE + 0x10000)
+
+// DVDD 1.25V (slower silicon may need the full 1.3, or just not work)
+#define FRAME_WIDTH 1280
+#define FRAME_HEIGHT 720
+#define VREG_VSEL VREG_VOLTAGE_1_25
+#define DVI_TIMING dvi_timing_1280x720p_30hz
+
+struct dvi_inst dvi0;
+
+int main() {
+	vreg_set_voltage(VREG_VSEL);
+	sleep_ms(10);
+	// Run system at TMDS bit clock
+	set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+
+	setup_default_uart();
+
+	const struct crle_header *clip = (const struct crle_header *)MOVIE_BASE;
+	if (clip->magic != CRLE_MAGIC || clip->width != FRAME_WIDTH || clip->height != FRAME_HEIGHT)
+		panic("No colour clip found at %08x\n", MOVIE_BASE);
+
+	dvi0.timing = &DVI_TIMING;
+	dvi0.ser_cfg = DVI_DEFAULT_SERIAL_CONFIG;
+	dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
+	dvi_register_irqs_this_core(&dvi0, DMA_IRQ_0);
+	dvi_start(&dvi0);
+
+	// The previous scanline is still queued or being displayed while we
+	// render the next one, so its buffer is safe to copy from (as long as
+	// there are at least 3 TMDS buffers).
+	uint32_t *prev = NULL;
+	while (true) {
+		const uint8_t *line = crle_first_line(clip);
+		for (uint frame = 0; frame < clip->n_frames; ++frame) {
+			for (uint y = 0; y < FRAME_HEIGHT; ++y) {
+				uint32_t *render_target;
+				queue_remove_blocking_u32(&dvi0.q_tmds_free, &render_target);
+				line = crle_decode_line(clip, line, render_target, prev);
+				queue_add_blocking_u32(&dvi0.q_tmds_valid, &render_target);
+				prev = render_target;
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef _RLE_COLOUR_DECOMPRESS_H
+#define _RLE_COLOUR_DECOMPRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Colour clip format, as produced by video/rle_colour_compress.py:
+//
+// - struct crle_header
+// - n_colours palette entries of 4 words each (see rle_colour_decompress.S)
+// - n_frames * height scanlines
+//
+// Each scanline starts with a type byte. CRLE_LINE_OPS is followed by the
+// ops for that scanline. CRLE_LINE_REF is followed by a 24-bit little-endian
+// distance, in bytes, back to an earlier CRLE_LINE_OPS scanline with the same
+// contents, which is decoded in its place. This is mostly used to repeat the
+// same scanline from the previous frame.
+//
+// Clips are always the full width of the display (the encoder pads them) so
+// the lane stride of the TMDS buffer is width / 2 words.
+
+#define CRLE_MAGIC 0x454c5243u // "CRLE"
+
+#define CRLE_LINE_OPS 0
+#define CRLE_LINE_REF 1
+
+struct crle_header {
+	uint32_t magic;
+	uint16_t width;
+	uint16_t height;
+	uint16_t n_frames;
+	uint16_t n_colours;
+};
+
+// Expand one scanline's ops into all three lanes of dst. prev is the
+// previous scanline's TMDS buffer, for the copy op. Returns a pointer to the
+// end of the ops.
+const uint8_t *rle_colour_to_tmds(const uint8_t *src, uint32_t *dst, const uint32_t *prev,
+	const uint32_t *palette, size_t words_per_lane);
+
+static inline const uint32_t *crle_palette(const struct crle_header *clip) {
+	return (const uint32_t*)(clip + 1);
+}
+
+static inline const uint8_t *crle_first_line(const struct crle_header *clip) {
+	return (const uint8_t*)(crle_palette(clip) + 4 * clip->n_colours);
+}
+
+// Decode the scanline at src, and return a pointer to the next scanline.
+static inline const uint8_t *crle_decode_line(const struct crle_header *clip, const uint8_t *src,
+		uint32_t *dst, const uint32_t *prev) {
+	if (*src == CRLE_LINE_REF) {
+		uint32_t dist = src[1] | (uint32_t)src[2] << 8 | (uint32_t)src[3] << 16;
+		rle_colour_to_tmds(src - dist + 1, dst, prev, crle_palette(clip), clip->width / 2);
+		return src + 4;
+	}
+	return rle_colour_to_tmds(src + 1, dst, prev, crle_palette(clip), clip->width / 2);
+}
+
+#endif
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+
+# Colour version of rle_compress.py. See rle_colour_decompress.h and
+# rle_colour_decompress.S for the format.
+#
+# We pick a small palette of colours for the whole clip, and then hold every
+# pair of those colours which appears in the clip as a prebalanced symbol pair
+# on each of the three lanes. A scanline is then a list of palette entries,
+# one per pixel pair, which we compress using:
+#
+# - Runs of one palette entry
+# - Copies from the scanline above
+# - Literal lists of palette entries
+# - References to an identical scanline earlier in the stream (usually the
+#   same scanline in the previous frame)
+#
+# Usage: rle_colour_compress.py [--colours n] [--width w] output.bin frame0.png frame1.png ...
+
+from PIL import Image
+import argparse
+import struct
+import sys
+
+CRLE_MAGIC = 0x454c5243
+CRLE_LINE_OPS = 0
+CRLE_LINE_REF = 1
+MAX_ENTRIES = 128
+MAX_REF_DIST = (1 << 24) - 1
+
+def popcount(x):
+	n = 0
+	while x:
+		n += 1
+		x = x & (x - 1)
+	return n
+
+# Equivalent to N1(q) - N0(q) in the DVI spec
+def byteimbalance(x):
+	return 2 * popcount(x) - 8
+
+# Data-only version of the encoder in scripts/tmdsfont (DVI 1.0 spec, figure 3-5)
+class TMDSEncode:
+	def __init__(self):
+		self.imbalance = 0
+
+	def encode(self, d):
+		q_m = d & 0x1
+		if popcount(d) > 4 or (popcount(d) == 4 and not d & 0x1):
+			for i in range(7):
+				q_m = q_m | (~(q_m >> i ^ d >> i + 1) & 0x1) << i + 1
+		else:
+			for i in range(7):
+				q_m = q_m | ( (q_m >> i ^ d >> i + 1) & 0x1) << i + 1
+			q_m = q_m | 0x100
+		inversion_mask = 0x2ff
+		q_out = 0
+		if self.imbalance == 0 or byteimbalance(q_m & 0xff) == 0:
+			q_out = q_m ^ (0 if q_m & 0x100 else inversion_mask)
+			if q_m & 0x100:
+				self.imbalance += byteimbalance(q_m & 0xff)
+			else:
+				self.imbalance -= byteimbalance(q_m & 0xff)
+		elif (self.imbalance > 0) == (byteimbalance(q_m & 0xff) > 0):
+			q_out = q_m ^ inversion_mask
+			self.imbalance += ((q_m & 0x100) >> 7) - byteimbalance(q_m & 0xff)
+		else:
+			q_out = q_m
+			self.imbalance += byteimbalance(q_m & 0xff) - ((~q_m & 0x100) >> 7)
+		return q_out
+
+# DC-balanced symbol pair for two levels, nudging them as little as possible
+# if the exact pair isn't balanced (there is usually one within +-8). x & ~1
+# followed by x | 1 is always balanced, so fall back to that with the average
+# of the two.
+def balanced_pair(a, b, radius=8):
+	candidates = sorted(((a + da, b + db) for da in range(-radius, radius + 1) for db in range(-radius, radius + 1)),
+		key=lambda ab: (max(abs(ab[0] - a), abs(ab[1] - b)), abs(ab[0] - a) + abs(ab[1] - b)))
+	for ca, cb in candidates:
+		if 0 <= ca <= 255 and 0 <= cb <= 255:
+			enc = TMDSEncode()
+			pair = enc.encode(ca) | enc.encode(cb) << 10
+			if enc.imbalance == 0:
+				return pair
+	avg = (a + b) // 2
+	enc = TMDSEncode()
+	return enc.encode(avg & 0xfe) | enc.encode(avg | 0x01) << 10
+
+def load_frames(filenames, width, n_colours):
+	frames = []
+	for fn in filenames:
+		img = Image.open(fn).convert("RGB")
+		if width is not None and width != img.width:
+			if width < img.width:
+				sys.exit("{} is wider than --width".format(fn))
+			padded = Image.new("RGB", (width, img.height))
+			padded.paste(img, ((width - img.width) // 2, 0))
+			img = padded
+		frames.append(img)
+	w, h = frames[0].size
+	if any(f.size != (w, h) for f in frames):
+		sys.exit("All frames must be the same size")
+	if w % 2:
+		sys.exit("Frame width must be even")
+	# One palette for the whole clip, chosen from a strip of (downscaled) frames
+	thumbs = [f.resize((max(w // 8, 1), max(h // 8, 1))) for f in frames]
+	strip = Image.new("RGB", (thumbs[0].width, thumbs[0].height * len(thumbs)))
+	for i, t in enumerate(thumbs):
+		strip.paste(t, (0, i * t.height))
+	pal_img = strip.quantize(n_colours)
+	palette = pal_img.getpalette()[:3 * n_colours]
+	palette = [tuple(palette[i:i + 3]) for i in range(0, len(palette), 3)]
+	indexed = [list(f.quantize(palette=pal_img, dither=Image.Dither.NONE).getdata()) for f in frames]
+	return w, h, palette, indexed
+
+def encode_ops(entries, above):
+	ops = bytearray()
+	uses_copy = False
+	i = 0
+	n = len(entries)
+	literal = []
+	def flush_literal():
+		if literal:
+			ops.append(0xc0 | (len(literal) - 1))
+			ops.extend(literal)
+			literal.clear()
+	while i < n:
+		run = 1
+		while i + run < n and run < 256 and entries[i + run] == entries[i]:
+			run += 1
+		copy = 0
+		if above is not None:
+			while i + copy < n and copy < 64 and above[i + copy] == entries[i + copy]:
+				copy += 1
+		if copy >= 2 and copy >= run:
+			flush_literal()
+			ops.append(0x80 | (copy - 1))
+			uses_copy = True
+			i += copy
+		elif run >= 3 or (run == 2 and not literal):
+			flush_literal()
+			ops.extend((entries[i], run - 1))
+			i += run
+		else:
+			literal.append(entries[i])
+			if len(literal) == 64:
+				flush_literal()
+			i += 1
+	flush_literal()
+	return bytes(ops), uses_copy
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser()
+	parser.add_argument("output", help="Output file name")
+	parser.add_argument("frames", nargs="+", help="Input frames, in order")
+	parser.add_argument("--colours", "-c", type=int, default=8,
+		help="Number of colours for the whole clip, default 8 (at most 11 gives every pair of colours a palette entry)")
+	parser.add_argument("--width", "-w", type=int, default=None,
+		help="Display width. Narrower frames are centred, as the clip must be full-width")
+	args = parser.parse_args()
+	if not 1 <= args.colours <= MAX_ENTRIES:
+		sys.exit("--colours must be between 1 and {}".format(MAX_ENTRIES))
+
+	w, h, palette, indexed = load_frames(args.frames, args.width, args.colours)
+
+	# Every pixel pair which appears gets a palette entry, as long as there's
+	# room. Single-colour pairs always get an entry, and other pairs which
+	# don't make the cut are drawn as their left pixel's colour.
+	pair_count = {}
+	for frame in indexed:
+		for i in range(0, len(frame), 2):
+			pair = (frame[i], frame[i + 1])
+			pair_count[pair] = pair_count.get(pair, 0) + 1
+	entries = [(c, c) for c in range(len(palette))]
+	mixed = sorted((p for p in pair_count if p[0] != p[1]), key=lambda p: -pair_count[p])
+	entries += mixed[:MAX_ENTRIES - len(entries)]
+	entry_index = {p: i for i, p in enumerate(entries)}
+
+	out = bytearray(struct.pack("<LHHHH", CRLE_MAGIC, w, h, len(indexed), len(entries)))
+	for a, b in entries:
+		for lane in (2, 1, 0):
+			out += struct.pack("<L", balanced_pair(palette[a][lane], palette[b][lane]))
+		out += struct.pack("<L", 0)
+
+	# Most recent ops scanline for each distinct content: (offset, uses copy, content above)
+	seen = {}
+	for frame in indexed:
+		above = None
+		for y in range(h):
+			row = frame[y * w:(y + 1) * w]
+			line = tuple(entry_index.get((row[i], row[i + 1]), row[i]) for i in range(0, w, 2))
+			ops, uses_copy = encode_ops(line, above)
+			ref = seen.get(line)
+			if ref is not None and len(ops) + 1 > 4 and len(out) - ref[0] <= MAX_REF_DIST and \
+					(not ref[1] or ref[2] == above):
+				out += struct.pack("<BL", CRLE_LINE_REF, len(out) - ref[0])[:4]
+			else:
+				seen[line] = (len(out), uses_copy, above)
+				out.append(CRLE_LINE_OPS)
+				out += ops
+			above = line
+
+	open(args.output, "wb").write(out)
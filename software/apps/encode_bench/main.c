@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+
+#include "dvi.h"
+#include "tmds_encode.h"
+
+// Time each TMDS encode loop, as built with this binary's
+// TMDS_ENCODE_UNROLL, on each core in turn. The CMakeLists builds one of
+// these for every unroll. Capture the UART output from each, and feed it to
+// scripts/tmds_autotune to pick the fastest valid settings:
+//
+//   tmds_autotune --timing dvi_timing_640x480p_60hz --format rgb565 \
+//       --log unroll1.txt --log unroll2.txt ... -o tmds_encode_tuned.h
+//
+// Loops whose pixels per iteration don't divide the scanline are reported as
+// invalid rather than run, since some of the Arm loops would run off the end
+// of the buffer and never terminate, and the rest would overrun it.
+
+#ifndef ENCODE_BENCH_TIMING
+#define ENCODE_BENCH_TIMING dvi_timing_640x480p_60hz
+#endif
+
+#define VREG_VSEL VREG_VOLTAGE_1_20
+#define REPS 1000
+
+#define H_ACTIVE_MAX 1600
+
+static uint32_t pixbuf[H_ACTIVE_MAX / 2];
+static uint32_t symbuf[N_TMDS_LANES * H_ACTIVE_MAX];
+
+static const struct dvi_timing *timing = &ENCODE_BENCH_TIMING;
+
+// Symbols produced by one iteration of each loop, which must divide the
+// scanline. Same rules as scripts/tmds_autotune.
+
+#if DVI_USE_SIO_TMDS_ENCODER
+// Matches the unroll calculation in tmds_encode_sio_loop
+static uint sio_symbols_per_iteration(uint ratio) {
+	uint words_in = ratio > 4 * TMDS_ENCODE_UNROLL ? 1 : 4 * TMDS_ENCODE_UNROLL / ratio;
+	return words_in * ratio * DVI_SYMBOLS_PER_WORD;
+}
+#endif
+
+static uint symbols_per_iteration_16bpp() {
+#if DVI_USE_SIO_TMDS_ENCODER
+	return sio_symbols_per_iteration(DVI_SYMBOLS_PER_WORD == 1 ? 4 : 2);
+#else
+	return 8 * TMDS_ENCODE_UNROLL;
+#endif
+}
+
+static uint symbols_per_iteration_8bpp() {
+#if DVI_USE_SIO_TMDS_ENCODER
+	return sio_symbols_per_iteration(DVI_SYMBOLS_PER_WORD == 1 ? 8 : 4);
+#else
+	return 8 * TMDS_ENCODE_UNROLL;
+#endif
+}
+
+static uint symbols_per_iteration_fullres() {
+#if DVI_USE_SIO_TMDS_ENCODER
+	return sio_symbols_per_iteration(DVI_SYMBOLS_PER_WORD == 1 ? 2 : 1);
+#else
+	// Fixed unroll of 16 in tmds_fullres_encode_loop_16bpp
+	return 64;
+#endif
+}
+
+static void encode_rgb565(uint w) {
+	tmds_encode_data_channel_16bpp(pixbuf, symbuf, w / 2, DVI_16BPP_BLUE_MSB, DVI_16BPP_BLUE_LSB);
+	tmds_encode_data_channel_16bpp(pixbuf, symbuf + w / DVI_SYMBOLS_PER_WORD, w / 2, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
+	tmds_encode_data_channel_16bpp(pixbuf, symbuf + 2 * w / DVI_SYMBOLS_PER_WORD, w / 2, DVI_16BPP_RED_MSB, DVI_16BPP_RED_LSB);
+}
+
+static void encode_rgb332(uint w) {
+	tmds_encode_data_channel_8bpp(pixbuf, symbuf, w / 2, DVI_8BPP_BLUE_MSB, DVI_8BPP_BLUE_LSB);
+	tmds_encode_data_channel_8bpp(pixbuf, symbuf + w / DVI_SYMBOLS_PER_WORD, w / 2, DVI_8BPP_GREEN_MSB, DVI_8BPP_GREEN_LSB);
+	tmds_encode_data_channel_8bpp(pixbuf, symbuf + 2 * w / DVI_SYMBOLS_PER_WORD, w / 2, DVI_8BPP_RED_MSB, DVI_8BPP_RED_LSB);
+}
+
+static void encode_rgb565_fullres(uint w) {
+	tmds_encode_data_channel_fullres_16bpp(pixbuf, symbuf, w, DVI_16BPP_BLUE_MSB, DVI_16BPP_BLUE_LSB);
+	tmds_encode_data_channel_fullres_16bpp(pixbuf, symbuf + w / DVI_SYMBOLS_PER_WORD, w, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
+	tmds_encode_data_channel_fullres_16bpp(pixbuf, symbuf + 2 * w / DVI_SYMBOLS_PER_WORD, w, DVI_16BPP_RED_MSB, DVI_16BPP_RED_LSB);
+}
+
+struct bench {
+	const char *name;
+	void (*encode)(uint w);
+	uint (*symbols_per_iteration)(void);
+};
+
+static const struct bench benches[] = {
+	{"rgb565",         encode_rgb565,         symbols_per_iteration_16bpp},
+	{"rgb332",         encode_rgb332,         symbols_per_iteration_8bpp},
+	{"rgb565-fullres", encode_rgb565_fullres, symbols_per_iteration_fullres},
+};
+
+static void run_benches() {
+	uint core = get_core_num();
+	uint w = timing->h_active_pixels;
+	uint h_total = timing->h_front_porch + timing->h_sync_width + timing->h_back_porch + w;
+	// clk_sys is the bit clock, so 10 cycles per pixel
+	uint budget = 10 * h_total;
+	for (uint i = 0; i < count_of(benches); ++i) {
+		const struct bench *b = &benches[i];
+		if (b->symbols_per_iteration && w % b->symbols_per_iteration()) {
+			printf("tmds_bench unroll=%d core=%u loop=%s invalid symbols_per_iteration=%u\n",
+				TMDS_ENCODE_UNROLL, core, b->name, b->symbols_per_iteration());
+			continue;
+		}
+		b->encode(w);
+		uint64_t t0 = time_us_64();
+		for (int rep = 0; rep < REPS; ++rep)
+			b->encode(w);
+		uint64_t t1 = time_us_64();
+		uint32_t cycles = (uint32_t)((t1 - t0) * (clock_get_hz(clk_sys) / 1000) / (1000 * REPS));
+		printf("tmds_bench unroll=%d core=%u loop=%s cycles=%lu budget=%u\n",
+			TMDS_ENCODE_UNROLL, core, b->name, (unsigned long)cycles, budget);
+	}
+}
+
+static void core1_main() {
+	run_benches();
+	multicore_fifo_push_blocking(0);
+	while (true)
+		__wfi();
+}
+
+int main() {
+	vreg_set_voltage(VREG_VSEL);
+	sleep_ms(10);
+	set_sys_clock_khz(timing->bit_clk_khz, true);
+
+	setup_default_uart();
+	// Give the host a moment to open the port
+	sleep_ms(2000);
+
+	if (timing->h_active_pixels > H_ACTIVE_MAX) {
+		printf("tmds_bench error: h_active_pixels %u > %d\n", timing->h_active_pixels, H_ACTIVE_MAX);
+		return 1;
+	}
+	for (uint i = 0; i < count_of(pixbuf); ++i)
+		pixbuf[i] = rand();
+
+	printf("tmds_bench start unroll=%d h_active=%u sys_khz=%lu symbols_per_word=%d sio_encoder=%d\n",
+		TMDS_ENCODE_UNROLL, timing->h_active_pixels, (unsigned long)(clock_get_hz(clk_sys) / 1000),
+		DVI_SYMBOLS_PER_WORD, DVI_USE_SIO_TMDS_ENCODER);
+	run_benches();
+	multicore_launch_core1(core1_main);
+	multicore_fifo_pop_blocking();
+	printf("tmds_bench done unroll=%d\n", TMDS_ENCODE_UNROLL);
+
+	while (true)
+		__wfi();
+}
@@ -9,15 +9,14 @@
 #include "hardware/vreg.h"
 
 #include "dvi.h"
+#include "dvi_clock.h"
 #include "dvi_serialiser.h"
 #include "common_dvi_pin_configs.h"
 
 #include "testcard_320x240_rgb565.h"
 
-// DVDD 1.2V (1.1V seems ok too)
 #define FRAME_WIDTH 320
 #define FRAME_HEIGHT 240
-#define VREG_VSEL VREG_VOLTAGE_1_20
 #define DVI_TIMING dvi_timing_640x480p_60hz
 
 struct dvi_inst dvi0;
@@ -31,11 +30,15 @@ void core1_main() {
 }
 
 int main() {
-	vreg_set_voltage(VREG_VSEL);
-	sleep_ms(10);
-	set_sys_clock_khz(DVI_TIMING.bit_clk_khz, true);
+	// Nearest clk_sys to the mode's bit clock, and the lowest DVDD for it
+	struct dvi_clock_solution clk;
+	if (!dvi_clock_solve(&DVI_TIMING, 1, DVI_CLOCK_TOLERANCE_PPM, NULL, 0, &clk))
+		panic("No clk_sys for this mode");
+	dvi_clock_apply(&clk);
 
 	setup_default_uart();
+	printf("clk_sys %lu kHz, vsel %d, refresh %lu mHz\n",
+		(unsigned long)clk.sys_khz, clk.vsel, (unsigned long)clk.refresh_mhz);
 
 	dvi0.timing = &DVI_TIMING;
 	dvi0.ser_cfg = DVI_DEFAULT_SERIAL_CONFIG;
@@ -46,24 +46,40 @@ FractalBuffer fractal;
 
 static uint8_t palette_offset = 0;
 
+static uint16_t palette_colour(uint8_t c) {
+  if (c < 0x20) return c;
+  else if (c < 0x40) return (c - 0x20) << 6;
+  else if (c < 0x60) return (c - 0x40) << 11;
+  else if (c < 0x80) return ((c - 0x60) & 0x1f) * 0x0840;
+  else if (c < 0xa0) return ((c - 0x80) & 0x1f) * 0x0041;
+  else if (c < 0xc0) return ((c - 0xa0) & 0x1f) * 0x0801;
+  else if (c < 0xe0) return ((c - 0xc0) & 0x1f) * 0x0841;
+  else return 0;
+}
+
 void init_palette() {
   palette[0] = 0;
   for (int i = 1; i < PALETTE_SIZE; ++i) {
-    uint8_t c = i + palette_offset;
-    if (c < 0x20) palette[i] = c;
-    else if (c < 0x40) palette[i] = (c - 0x20) << 6;
-    else if (c < 0x60) palette[i] = (c - 0x40) << 11;
-    else if (c < 0x80) palette[i] = ((c - 0x60) & 0x1f) * 0x0840;
-    else if (c < 0xa0) palette[i] = ((c - 0x80) & 0x1f) * 0x0041;
-    else if (c < 0xc0) palette[i] = ((c - 0xa0) & 0x1f) * 0x0801;
-    else if (c < 0xe0) palette[i] = ((c - 0xc0) & 0x1f) * 0x0841;
-    else palette[i] = 0;
+    palette[i] = palette_colour(i + palette_offset);
   }
   ++palette_offset;
 
   tmds_setup_palette_symbols(palette, tmds_palette, PALETTE_SIZE);
 }
 
+// Same result as calling init_palette() again, but only one entry is
+// re-encoded: the rest of entries 1..255 just move down by one.
+void cycle_palette() {
+  for (int i = 1; i < PALETTE_SIZE - 1; ++i) {
+    palette[i] = palette[i + 1];
+  }
+  palette[PALETTE_SIZE - 1] = palette_colour(PALETTE_SIZE - 1 + palette_offset);
+  ++palette_offset;
+
+  tmds_rotate_palette_symbols(tmds_palette, PALETTE_SIZE, 1, PALETTE_SIZE - 1, -1);
+  tmds_update_palette_symbols(palette, tmds_palette, PALETTE_SIZE, PALETTE_SIZE - 1, 1);
+}
+
 void init_mandel() {
   for (int y = 0; y < (FRAME_HEIGHT / 2); ++y) {
     uint8_t* buf = &mandel[y * FRAME_WIDTH];
@@ -163,7 +179,7 @@ int __not_in_flash("main") main() {
       encode_time = 0;
     }
     if (fractal.done) zoom_mandel();
-    //if (heartbeat & 1) init_palette();
+    //if (heartbeat & 1) cycle_palette();
     for (int y = 0; y < FRAME_HEIGHT / 2; y += 2) {
       uint32_t *our_tmds_buf, *their_tmds_buf;
       queue_remove_blocking_u32(&dvi0.q_tmds_free, &their_tmds_buf);
@@ -6,8 +6,8 @@
 #include "dvi.h"
 #include "dvi_serialiser.h"
 #include "common_dvi_pin_configs.h"
-#include "tmds_encode_1bpp.pio.h"
 #include "tmds_encode.h"
+#include "tmds_encode_pio.h"
 
 // Display a full-resolution 1bpp image. By default this uses the fast 1bpp
 // encode routine from libdvi (which is actually fast enough for bitplaned
@@ -56,31 +56,8 @@ int main() {
 	// (note there are two build targets for this app, called `moon` and
 	// `moon_pio_encode`, so a simple `make all` will get you both binaries)
 #ifdef USE_PIO_TMDS_ENCODE
-	PIO encode_pio = dvi0.ser_cfg.pio;
-	uint encode_sm = pio_claim_unused_sm(encode_pio, true);
-	tmds_encode_1bpp_init(encode_pio, encode_sm);
-
-	uint dma_chan_put = dma_claim_unused_channel(true);
-	dma_channel_config c = dma_channel_get_default_config(dma_chan_put);
-	channel_config_set_dreq(&c, pio_get_dreq(encode_pio, encode_sm, true));
-	dma_channel_configure(dma_chan_put, &c,
-		&encode_pio->txf[encode_sm],
-		NULL,
-		FRAME_WIDTH / 32,
-		false
-	);
-
-	uint dma_chan_get = dma_claim_unused_channel(true);
-	c = dma_channel_get_default_config(dma_chan_get);
-	channel_config_set_dreq(&c, pio_get_dreq(encode_pio, encode_sm, false));
-	channel_config_set_write_increment(&c, true);
-	channel_config_set_read_increment(&c, false);
-	dma_channel_configure(dma_chan_get, &c,
-		NULL,
-		&encode_pio->rxf[encode_sm],
-		FRAME_WIDTH / DVI_SYMBOLS_PER_WORD,
-		false
-	);
+	static struct tmds_pio_encoder encoder;
+	tmds_pio_encoder_init(&encoder, dvi0.ser_cfg.pio, 1, 1, false, FRAME_WIDTH);
 #endif
 
 	dvi_start(&dvi0);
@@ -92,9 +69,7 @@ int main() {
 #ifndef USE_PIO_TMDS_ENCODE
 			tmds_encode_1bpp(colourbuf, tmdsbuf, FRAME_WIDTH);
 #else
-			dma_channel_set_read_addr(dma_chan_put, colourbuf, true);
-			dma_channel_set_write_addr(dma_chan_get, tmdsbuf, true);
-			dma_channel_wait_for_finish_blocking(dma_chan_get);
+			tmds_pio_encode(&encoder, &colourbuf, tmdsbuf);
 #endif
 			queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmdsbuf);
 		}
@@ -178,7 +178,9 @@ int main() {
 		berry[i].x = rand() % (xmax - xmin + 1) + xmin;
 		berry[i].y = rand() % (ymax - ymin + 1) + ymin;
 		berry[i].img = i % 2 ? eben_128x128 : raspberry_128x128;
-		berry[i].log_size = 7;
+		berry[i].width = 128;
+		berry[i].height = 128;
+		berry[i].stride = 0;
 		berry[i].has_opacity_metadata = true; // Much faster non-AT blitting
 		berry[i].hflip = false;
 		berry[i].vflip = false;
@@ -89,11 +89,18 @@ typedef struct {
 	uint8_t anim_frame;
 } character_t;
 
+#define MAX_CHAR_TILES 2
+#define N_SPRITES (N_CHARACTERS * MAX_CHAR_TILES)
+
 typedef struct {
 	int16_t cam_x;
 	int16_t cam_y;
 	uint32_t frame_ctr;
 	character_t chars[N_CHARACTERS];
+	// Character tiles in screen space, rebuilt each frame
+	sprite_t sprites[N_SPRITES];
+	uint16_t sprite_order[N_SPRITES];
+	sprite_list_t sprite_list;
 } game_state_t;
 
 static inline int clip(int x, int min, int max) {
@@ -117,6 +124,30 @@ void game_init(game_state_t *state) {
 		state->chars[i].tilestride = 17;
 		state->chars[i].ntiles = 2;
 	}
+	sprite_list_init(&state->sprite_list, state->sprites, state->sprite_order, 0);
+}
+
+// Place each character's tiles on screen, and sort them by y so each
+// scanline only visits the sprites it intersects
+void update_sprites(game_state_t *state) {
+	uint n = 0;
+	for (int i = 0; i < N_CHARACTERS; ++i) {
+		const character_t *ch = &state->chars[i];
+		const uint16_t *basetile = (const uint16_t*)zelda_mini_plus_walk +
+			16 * 16 * (102 + (ch->dir << 2) + ch->anim_frame);
+		for (int tile = 0; tile < ch->ntiles && tile < MAX_CHAR_TILES; ++tile) {
+			state->sprites[n++] = (sprite_t){
+				.x = ch->pos_x - state->cam_x,
+				.y = ch->pos_y - state->cam_y + tile * 16,
+				.img = basetile + tile * ch->tilestride * 16 * 16,
+				.width = 16,
+				.height = 16,
+				.has_opacity_metadata = false
+			};
+		}
+	}
+	sprite_list_set_count(&state->sprite_list, n);
+	sprite_list_sort(&state->sprite_list);
 }
 
 void update(game_state_t *state) {
@@ -161,7 +192,7 @@ void update(game_state_t *state) {
 }
 
 
-void render_scanline(uint16_t *pixbuf, uint y, const game_state_t *gstate) {
+void render_scanline(uint16_t *pixbuf, uint y, const game_state_t *gstate, sprite_list_cursor_t *cursor) {
 	tilebg_t bg = {
 		.xscroll = gstate->cam_x,
 		.yscroll = gstate->cam_y,
@@ -173,24 +204,8 @@ void render_scanline(uint16_t *pixbuf, uint y, const game_state_t *gstate) {
 		.fill_loop = (tile_loop_t)tile16_16px_loop
 	};
 
-	sprite_t sp = {
-		.log_size = 4,
-		.has_opacity_metadata = false,
-	};
-
 	tile16(pixbuf, &bg, y, FRAME_WIDTH);
-
-	for (int i = 0; i < N_CHARACTERS; ++i) {
-		const character_t *ch = &gstate->chars[i];
-		sp.x = ch->pos_x - gstate->cam_x;
-		const uint16_t *basetile = (const uint16_t*)zelda_mini_plus_walk +
-			16 * 16 * (102 + (ch->dir << 2) + ch->anim_frame);
-		for (int tile = 0; tile < ch->ntiles; ++tile) {
-			sp.y = ch->pos_y - gstate->cam_y + tile * 16;
-			sp.img = basetile + tile * ch->tilestride * 16 * 16;
-			sprite_sprite16(pixbuf, &sp, y, FRAME_WIDTH);
-		}
-	}
+	sprite_list_sprite16(pixbuf, cursor, y, FRAME_WIDTH);
 }
 
 // ----------------------------------------------------------------------------
@@ -202,10 +217,18 @@ game_state_t state;
 uint16_t __scratch_y("render") __attribute__((aligned(4))) core0_scanbuf[FRAME_WIDTH];
 uint16_t __scratch_x("render") __attribute__((aligned(4))) core1_scanbuf[FRAME_WIDTH];
 
+// Each core renders every other line, so has its own place in the sprite list
+sprite_list_cursor_t core0_cursor;
+sprite_list_cursor_t core1_cursor;
+
 // - Core 0 pops two TMDS buffers
 // - Passes one to core 1
 // - Renders own buffer and pushes to DVI queue  <- core 1 waits here before starting DVI
 // - Retrieves core 1's TMDS buffer and pushes that to DVI queue as well
+//
+// At the start of each frame, core 0 also passes core 1 a token once it has
+// finished updating the game state. sprite_list_sort() reorders the list in
+// place, so core 1 must not walk it until then.
 
 void encode_scanline(uint16_t *pixbuf, uint32_t *tmdsbuf) {
 	uint pixwidth = dvi0.timing->h_active_pixels;
@@ -221,8 +244,10 @@ void core1_main() {
 		__wfe();
 	dvi_start(&dvi0);
 	while (1) {
+		// Frame start token
+		(void)multicore_fifo_pop_blocking();
 		for (uint y = 1; y < FRAME_HEIGHT; y += 2) {
-			render_scanline(core1_scanbuf, y, &state);
+			render_scanline(core1_scanbuf, y, &state, &core1_cursor);
 			uint32_t *tmdsbuf = (uint32_t*)multicore_fifo_pop_blocking();
 			encode_scanline(core1_scanbuf, tmdsbuf);
 			multicore_fifo_push_blocking((uintptr_t)tmdsbuf);
@@ -246,24 +271,30 @@ int main() {
 	dvi0.ser_cfg = DVI_DEFAULT_SERIAL_CONFIG;
 	dvi_init(&dvi0, next_striped_spin_lock_num(), next_striped_spin_lock_num());
 
+	game_init(&state);
+	update_sprites(&state);
+	sprite_list_cursor_init(&core0_cursor, &state.sprite_list);
+	sprite_list_cursor_init(&core1_cursor, &state.sprite_list);
+
 	printf("Core 1 start\n");
 	multicore_launch_core1(core1_main);
 
 	printf("Start rendering\n");
-	game_init(&state);
 	while (1) {
+		multicore_fifo_push_blocking(0);
 		for (uint y = 0; y < FRAME_HEIGHT; y += 2) {
 			uint32_t *tmds0, *tmds1;
 			queue_remove_blocking_u32(&dvi0.q_tmds_free, &tmds0);
 			queue_remove_blocking_u32(&dvi0.q_tmds_free, &tmds1);
 			multicore_fifo_push_blocking((uintptr_t)tmds1);
-			render_scanline(core0_scanbuf, y, &state);
+			render_scanline(core0_scanbuf, y, &state, &core0_cursor);
 			encode_scanline(core0_scanbuf, tmds0);
 			queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmds0);
 			tmds1 = (uint32_t*)multicore_fifo_pop_blocking();
 			queue_add_blocking_u32(&dvi0.q_tmds_valid, &tmds1);
 		}
 		update(&state);
+		update_sprites(&state);
 	}
 
 	__builtin_unreachable();
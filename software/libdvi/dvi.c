@@ -19,6 +19,18 @@ static void dvi_dma0_irq();
 static void dvi_dma1_irq();
 
 void dvi_init(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_colour_queue) {
+	// Every horizontal segment is a whole number of TMDS words
+	const struct dvi_timing *t = inst->timing;
+	if (t->h_front_porch % DVI_SYMBOLS_PER_WORD || t->h_sync_width % DVI_SYMBOLS_PER_WORD ||
+		t->h_back_porch % DVI_SYMBOLS_PER_WORD || t->h_active_pixels % DVI_SYMBOLS_PER_WORD)
+		panic("DVI horizontal timings must be divisible by DVI_SYMBOLS_PER_WORD (%d)", DVI_SYMBOLS_PER_WORD);
+	// The odd field's vsync edges are half a line after the start of hsync,
+	// which must be a word boundary within the active period
+	uint h_total = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+	if (t->interlaced && (h_total % (2 * DVI_SYMBOLS_PER_WORD) ||
+		h_total / 2 <= t->h_sync_width + t->h_back_porch || h_total / 2 >= h_total - t->h_front_porch))
+		panic("Interlaced horizontal total must be divisible by 2 * DVI_SYMBOLS_PER_WORD (%d)", 2 * DVI_SYMBOLS_PER_WORD);
+
 	dvi_timing_state_init(&inst->timing_state);
 	dvi_serialiser_init(&inst->ser_cfg);
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
@@ -39,6 +51,11 @@ void dvi_init(struct dvi_inst *inst, uint spinlock_tmds_queue, uint spinlock_col
 	dvi_setup_scanline_for_vblank(inst->timing, inst->dma_cfg, false, &inst->dma_list_vblank_nosync);
 	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, (void*)SRAM_BASE, &inst->dma_list_active);
 	dvi_setup_scanline_for_active(inst->timing, inst->dma_cfg, NULL, &inst->dma_list_error);
+	if (t->interlaced) {
+		dvi_setup_scanline_for_vblank_half(inst->timing, inst->dma_cfg, false, &inst->dma_list_vblank_sync_start);
+		dvi_setup_scanline_for_vblank_half(inst->timing, inst->dma_cfg, true, &inst->dma_list_vblank_sync_end);
+	}
+	inst->sync_lane_tail_words = dvi_sync_lane_tail_words(&inst->dma_list_vblank_nosync);
 
 	for (int i = 0; i < DVI_N_TMDS_BUFFERS; ++i) {
 		void *tmdsbuf;
@@ -114,26 +131,46 @@ void dvi_start(struct dvi_inst *inst) {
 	dvi_serialiser_enable(&inst->ser_cfg, true);
 }
 
-static inline void __dvi_func_x(_dvi_prepare_scanline_8bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
-	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+static inline void __dvi_func_x(_dvi_encode_scanline_8bpp)(struct dvi_inst *inst, const uint32_t *scanbuf, uint32_t *tmdsbuf) {
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
 	// Scanline buffers are half-resolution; the functions take the number of *input* pixels as parameter.
+#if DVI_MONOCHROME_TMDS
+	// One lane only, and the pixels are 8 bit greyscale rather than RGB332
+	(void)words_per_channel;
+	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf, pixwidth / 2, 7, 0);
+#else
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_8BPP_BLUE_MSB,  DVI_8BPP_BLUE_LSB );
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_8BPP_GREEN_MSB, DVI_8BPP_GREEN_LSB);
 	tmds_encode_data_channel_8bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_8BPP_RED_MSB,   DVI_8BPP_RED_LSB  );
-	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+#endif
 }
 
-static inline void __dvi_func_x(_dvi_prepare_scanline_16bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
-	uint32_t *tmdsbuf;
-	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+static inline void __dvi_func_x(_dvi_encode_scanline_16bpp)(struct dvi_inst *inst, const uint32_t *scanbuf, uint32_t *tmdsbuf) {
 	uint pixwidth = inst->timing->h_active_pixels;
 	uint words_per_channel = pixwidth / DVI_SYMBOLS_PER_WORD;
+#if DVI_MONOCHROME_TMDS
+	// One lane only: green is the widest channel and the closest to luma
+	(void)words_per_channel;
+	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf, pixwidth / 2, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
+#else
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 0 * words_per_channel, pixwidth / 2, DVI_16BPP_BLUE_MSB,  DVI_16BPP_BLUE_LSB );
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 1 * words_per_channel, pixwidth / 2, DVI_16BPP_GREEN_MSB, DVI_16BPP_GREEN_LSB);
 	tmds_encode_data_channel_16bpp(scanbuf, tmdsbuf + 2 * words_per_channel, pixwidth / 2, DVI_16BPP_RED_MSB,   DVI_16BPP_RED_LSB  );
+#endif
+}
+
+static inline void __dvi_func_x(_dvi_prepare_scanline_8bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
+	uint32_t *tmdsbuf;
+	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	_dvi_encode_scanline_8bpp(inst, scanbuf, tmdsbuf);
+	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+}
+
+static inline void __dvi_func_x(_dvi_prepare_scanline_16bpp)(struct dvi_inst *inst, uint32_t *scanbuf) {
+	uint32_t *tmdsbuf;
+	queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+	_dvi_encode_scanline_16bpp(inst, scanbuf, tmdsbuf);
 	queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
 }
 
@@ -171,6 +208,79 @@ void __dvi_func(dvi_scanbuf_main_16bpp)(struct dvi_inst *inst) {
 	__builtin_unreachable();
 }
 
+static void __dvi_func(_dvi_encode_band_line)(struct dvi_inst *inst, const struct dvi_band *band, uint band_y, uint32_t *tmdsbuf) {
+	uint pixwidth = inst->timing->h_active_pixels;
+	const uint n_lanes = DVI_MONOCHROME_TMDS ? 1 : N_TMDS_LANES;
+	if (band->format == DVI_BAND_SOLID) {
+		tmds_encode_solid_rgb888(band->colour, tmdsbuf, pixwidth, n_lanes);
+		return;
+	}
+
+	uint32_t *src;
+	if (band->src)
+		src = (uint32_t*)((uintptr_t)band->src + band_y * band->stride);
+	else
+		queue_remove_blocking_u32(&inst->q_colour_valid, &src);
+
+	switch (band->format) {
+	case DVI_BAND_16BPP:
+		_dvi_encode_scanline_16bpp(inst, src, tmdsbuf);
+		break;
+	case DVI_BAND_8BPP:
+		_dvi_encode_scanline_8bpp(inst, src, tmdsbuf);
+		break;
+#if DVI_SYMBOLS_PER_WORD == 2
+	case DVI_BAND_1BPP:
+		if (band->colour_tables && n_lanes == 1)
+			tmds_encode_1bpp_table(src, tmdsbuf, pixwidth, band->colour_tables + 32);
+		else if (band->colour_tables)
+			tmds_encode_1bpp_colour(src, band->colour_tables, tmdsbuf, pixwidth, 1, 0);
+		else
+			for (uint lane = 0; lane < n_lanes; ++lane)
+				tmds_encode_1bpp(src, tmdsbuf + lane * (pixwidth / 2), pixwidth);
+		break;
+#endif
+	default:
+		panic_unsupported();
+	}
+
+	if (!band->src)
+		queue_add_blocking_u32(&inst->q_colour_free, &src);
+}
+
+// Version where the format and source of each line come from a table of
+// bands. The table is reread on every line, so it can be modified while
+// running, e.g. to scroll a band by moving its src.
+void __dvi_func(dvi_scanbuf_main_bands)(struct dvi_inst *inst, const struct dvi_band *bands, uint n_bands) {
+	// Interlaced: bands cover the frame, and each field takes every other line
+	uint y_step = inst->timing->interlaced ? 2 : 1;
+	uint frame_height = y_step * inst->timing->v_active_lines / DVI_VERTICAL_REPEAT;
+	if (!n_bands || bands[n_bands - 1].y_end != frame_height)
+		panic("Last band must end at line %u", frame_height);
+	uint field = 0;
+	uint y = 0;
+	uint band = 0;
+	uint band_y0 = 0;
+	while (1) {
+		uint32_t *tmdsbuf;
+		queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		_dvi_encode_band_line(inst, &bands[band], y - band_y0, tmdsbuf);
+		queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+		y += y_step;
+		if (y >= frame_height) {
+			field = (field + 1) % y_step;
+			y = field;
+			band = 0;
+			band_y0 = 0;
+		}
+		while (y >= bands[band].y_end) {
+			band_y0 = bands[band].y_end;
+			++band;
+		}
+	}
+	__builtin_unreachable();
+}
+
 static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst) {
 	// Every fourth interrupt marks the start of the horizontal active region. We
 	// now have until the end of this region to generate DMA blocklist for next
@@ -184,7 +294,8 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst) {
 	// Make sure all three channels have definitely loaded their last block
 	// (should be within a few cycles of one another)
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
-		while (dma_debug_hw->ch[inst->dma_cfg[i].chan_data].dbg_tcr != inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD)
+		uint tail_words = i == TMDS_SYNC_LANE ? inst->sync_lane_tail_words : inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD;
+		while (dma_debug_hw->ch[inst->dma_cfg[i].chan_data].dbg_tcr != tail_words)
 			tight_loop_contents();
 	}
 
@@ -227,12 +338,24 @@ static void __dvi_func(dvi_dma_irq_handler)(struct dvi_inst *inst) {
 			}
 			break;
 		case DVI_STATE_SYNC:
+			// Only ever true for interlaced timings
+			if (inst->timing_state.field && inst->timing_state.v_ctr == 0) {
+				_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_sync_start);
+				inst->sync_lane_tail_words = dvi_sync_lane_tail_words(&inst->dma_list_vblank_sync_start);
+				return;
+			}
+			else if (inst->timing_state.field && inst->timing_state.v_ctr == inst->timing->v_sync_width) {
+				_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_sync_end);
+				inst->sync_lane_tail_words = dvi_sync_lane_tail_words(&inst->dma_list_vblank_sync_end);
+				return;
+			}
 			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_sync);
 			break;
 		default:
 			_dvi_load_dma_op(inst->dma_cfg, &inst->dma_list_vblank_nosync);
 			break;
 	}
+	inst->sync_lane_tail_words = inst->timing->h_active_pixels / DVI_SYMBOLS_PER_WORD;
 }
 
 static void __dvi_func(dvi_dma0_irq)() {
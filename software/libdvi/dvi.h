@@ -31,6 +31,11 @@ struct dvi_inst {
 	struct dvi_scanline_dma_list dma_list_vblank_nosync;
 	struct dvi_scanline_dma_list dma_list_active;
 	struct dvi_scanline_dma_list dma_list_error;
+	// Odd field vsync start/end lines of interlaced timings
+	struct dvi_scanline_dma_list dma_list_vblank_sync_start;
+	struct dvi_scanline_dma_list dma_list_vblank_sync_end;
+	// Sync lane words still to go when the IRQ for the current list fires
+	uint sync_lane_tail_words;
 
 	// After a TMDS buffer has been enqueue via a control block for the last
 	// time, two IRQs must go by before freeing. The first indicates the control
@@ -63,12 +68,70 @@ void dvi_register_irqs_this_core(struct dvi_inst *inst, uint irq_num);
 // DVI, have registered the IRQs, and are producing rendered scanlines.
 void dvi_start(struct dvi_inst *inst);
 
+// For interlaced timings, the field (0 = even lines of the frame, 1 = odd)
+// currently being scanned out. This changes at the end of each field's active
+// lines. Producers queue scanlines ahead of this, so rather than sampling it
+// they should count lines: scanlines are consumed strictly in order from the
+// start of field 0, so the n'th scanline queued belongs to field
+// (n / lines per field) % 2, where there are v_active_lines /
+// DVI_VERTICAL_REPEAT lines per field.
+static inline uint dvi_current_field(const struct dvi_inst *inst) {
+	return inst->timing_state.field;
+}
+
+// Interpolators: TMDS encode (and the libsprite tile and affine sprite
+// kernels) leaves interp0/interp1 on the encoding core configured for its own
+// use, and no longer saves and restores their state around each call. Its
+// ownership is tracked per core in libinterp/interp_owner.h. Application code
+// on the same core that also uses the interpolators must not expect its
+// configuration to survive a call into libdvi. Either claim them with a key
+// from INTERP_OWNER_USER upward before each use, or call
+// interp_owner_invalidate() when done so the encoder reconfigures them.
+// Interrupt handlers must still save and restore any interpolator they use.
+
 // TMDS encode worker function: core enters and doesn't leave, but still
 // responds to IRQs. Repeatedly pop a scanline buffer from q_colour_valid,
-// TMDS encode it, and pass it to the tmds valid queue.
+// TMDS encode it, and pass it to the tmds valid queue. With
+// DVI_MONOCHROME_TMDS, the 8bpp version takes 8 bit greyscale pixels, and the
+// 16bpp version encodes only the green channel.
 void dvi_scanbuf_main_8bpp(struct dvi_inst *inst);
 void dvi_scanbuf_main_16bpp(struct dvi_inst *inst);
 
+enum dvi_band_format {
+	DVI_BAND_16BPP, // RGB565, pixel-doubled (h_active_pixels / 2 pixels per line)
+	DVI_BAND_8BPP,  // RGB332, pixel-doubled
+	DVI_BAND_1BPP,  // Full resolution, packed 32 per word (as tmds_encode_1bpp)
+	DVI_BAND_SOLID  // One colour, with no source buffer
+};
+
+// A horizontal band of the screen, from the end of the previous band (or the
+// top of the screen) down to, but not including, line y_end. Lines are
+// counted in TMDS buffers, i.e. v_active_lines / DVI_VERTICAL_REPEAT per
+// frame. For interlaced timings, bands cover the whole frame (both fields),
+// and each field encodes only its own lines.
+//
+// src is the source for the band's first line, and stride the number of
+// bytes between lines. If src is NULL, each line of the band is instead
+// popped from q_colour_valid and returned to q_colour_free, as with
+// dvi_scanbuf_main_16bpp, so it can be rendered a scanline at a time.
+//
+// colour is the RGB888 colour of a DVI_BAND_SOLID band. colour_tables is
+// one colour pair from tmds_setup_1bpp_colour_tables() for a DVI_BAND_1BPP
+// band, or NULL for white on black. 1bpp bands need DVI_SYMBOLS_PER_WORD == 2.
+struct dvi_band {
+	uint16_t y_end;
+	uint8_t format;
+	const void *src;
+	uint32_t stride;
+	uint32_t colour;
+	const uint32_t *colour_tables;
+};
+
+// Same as above, but each line is encoded according to its band, so e.g. a
+// status bar and a text log don't cost as much as a 16bpp picture. The last
+// band must end at the bottom of the screen.
+void dvi_scanbuf_main_bands(struct dvi_inst *inst, const struct dvi_band *bands, uint n_bands);
+
 // Same as above, but each q_colour_valid entry is a framebuffer
 void dvi_framebuf_main_8bpp(struct dvi_inst *inst);
 void dvi_framebuf_main_16bpp(struct dvi_inst *inst);
@@ -0,0 +1,100 @@
+#include "dvi_clock.h"
+#if !PICO_NO_HARDWARE
+#include "pico/stdlib.h"
+#include "hardware/vreg.h"
+#endif
+
+// The search covers the same settings as check_sys_clock_khz() in the SDK
+// (reference divider of 1, postdiv2 <= postdiv1), and only considers outputs
+// which are a whole number of kHz, so the returned frequency is exact.
+
+static bool pll_out_khz(uint32_t vco_khz, uint pd1, uint pd2, uint32_t *out_khz) {
+	if (vco_khz < DVI_CLOCK_VCO_MIN_KHZ || vco_khz > DVI_CLOCK_VCO_MAX_KHZ)
+		return false;
+	*out_khz = vco_khz / (pd1 * pd2);
+	return *out_khz * pd1 * pd2 == vco_khz;
+}
+
+uint32_t dvi_clock_pll_nearest_khz(uint32_t target_khz, struct dvi_pll_cfg *cfg) {
+	uint32_t best_khz = 0;
+	uint32_t best_err = UINT32_MAX;
+	struct dvi_pll_cfg best = {0};
+	for (uint pd1 = 1; pd1 <= 7; ++pd1) {
+		for (uint pd2 = 1; pd2 <= pd1; ++pd2) {
+			// Nearest feedback divider for this postdiv, and its neighbour
+			uint32_t fbdiv_lo = (uint32_t)(((uint64_t)target_khz * pd1 * pd2) / DVI_CLOCK_XOSC_KHZ);
+			for (uint32_t fbdiv = fbdiv_lo; fbdiv <= fbdiv_lo + 1; ++fbdiv) {
+				uint32_t vco_khz = fbdiv * DVI_CLOCK_XOSC_KHZ;
+				uint32_t out_khz;
+				if (fbdiv < 16 || fbdiv > 320 || !pll_out_khz(vco_khz, pd1, pd2, &out_khz))
+					continue;
+				uint32_t err = out_khz > target_khz ? out_khz - target_khz : target_khz - out_khz;
+				if (err < best_err || (err == best_err && (out_khz < best_khz ||
+						(out_khz == best_khz && vco_khz < best.vco_khz)))) {
+					best_err = err;
+					best_khz = out_khz;
+					best = (struct dvi_pll_cfg){.vco_khz = vco_khz, .postdiv1 = pd1, .postdiv2 = pd2};
+				}
+			}
+		}
+	}
+	if (cfg)
+		*cfg = best;
+	return best_khz;
+}
+
+uint32_t dvi_clock_refresh_mhz(const struct dvi_timing *t, uint32_t bit_clk_khz) {
+	uint64_t h_total = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+	uint64_t v_total = t->v_front_porch + t->v_sync_width + t->v_back_porch + t->v_active_lines;
+	// 10 bits per pixel, and mHz rather than Hz
+	return (uint32_t)((uint64_t)bit_clk_khz * 100000 / (h_total * v_total));
+}
+
+#if !PICO_NO_HARDWARE
+
+const struct dvi_clock_vreg_point dvi_clock_vreg_default[] = {
+#if DVI_CLOCK_VREG_BELOW_1V2
+	{200000, VREG_VOLTAGE_1_10},
+	{260000, VREG_VOLTAGE_1_15},
+#endif
+	{300000, VREG_VOLTAGE_1_20},
+	{380000, VREG_VOLTAGE_1_25},
+	{420000, VREG_VOLTAGE_1_30},
+};
+const uint dvi_clock_vreg_default_count = count_of(dvi_clock_vreg_default);
+
+bool dvi_clock_solve(const struct dvi_timing *t, uint clk_div, uint32_t tolerance_ppm,
+		const struct dvi_clock_vreg_point *vreg_table, uint n_vreg, struct dvi_clock_solution *sol) {
+	if (!vreg_table) {
+		vreg_table = dvi_clock_vreg_default;
+		n_vreg = dvi_clock_vreg_default_count;
+	}
+	if (!clk_div)
+		clk_div = 1;
+	uint32_t nominal_khz = t->bit_clk_khz * clk_div;
+	uint32_t slack_khz = (uint32_t)((uint64_t)nominal_khz * tolerance_ppm / 1000000);
+	sol->sys_khz = dvi_clock_pll_nearest_khz(nominal_khz, &sol->pll);
+	if (!sol->sys_khz || sol->sys_khz < nominal_khz - slack_khz || sol->sys_khz > nominal_khz + slack_khz)
+		return false;
+
+	uint i;
+	for (i = 0; i < n_vreg; ++i) {
+		if (sol->sys_khz <= vreg_table[i].max_khz)
+			break;
+	}
+	if (i == n_vreg)
+		return false;
+	sol->vsel = vreg_table[i].vsel;
+
+	sol->refresh_mhz = dvi_clock_refresh_mhz(t, sol->sys_khz / clk_div);
+	sol->refresh_error_ppm = (int32_t)(((int64_t)sol->sys_khz - nominal_khz) * 1000000 / nominal_khz);
+	return true;
+}
+
+void dvi_clock_apply(const struct dvi_clock_solution *sol) {
+	vreg_set_voltage(sol->vsel);
+	sleep_ms(10);
+	set_sys_clock_pll(sol->pll.vco_khz * 1000, sol->pll.postdiv1, sol->pll.postdiv2);
+}
+
+#endif // !PICO_NO_HARDWARE
@@ -0,0 +1,109 @@
+#ifndef _DVI_CLOCK_H
+#define _DVI_CLOCK_H
+
+#include "pico.h"
+#if !PICO_NO_HARDWARE
+#include "hardware/vreg.h"
+#endif
+
+#include "dvi_timing_defs.h"
+
+// The serialiser shifts out one bit every clk_div clk_sys cycles (see struct
+// dvi_serialiser_cfg), so clk_sys must be clk_div times the TMDS bit clock,
+// and it comes from the system PLL. With the default clk_div of 1, clk_sys is
+// the bit clock. These helpers find out what the PLL can really generate, and
+// what core voltage that frequency needs.
+// Only dvi_clock_apply() touches any hardware. The PLL search also builds
+// for the host (PICO_NO_HARDWARE), for testing; the voltage parts don't.
+
+#ifndef DVI_CLOCK_XOSC_KHZ
+#if defined(XOSC_KHZ)
+#define DVI_CLOCK_XOSC_KHZ XOSC_KHZ
+#elif defined(XOSC_HZ)
+#define DVI_CLOCK_XOSC_KHZ (XOSC_HZ / 1000)
+#else
+#define DVI_CLOCK_XOSC_KHZ 12000
+#endif
+#endif
+
+#ifndef DVI_CLOCK_VCO_MIN_KHZ
+#ifdef PICO_PLL_VCO_MIN_FREQ_KHZ
+#define DVI_CLOCK_VCO_MIN_KHZ PICO_PLL_VCO_MIN_FREQ_KHZ
+#else
+#define DVI_CLOCK_VCO_MIN_KHZ 750000
+#endif
+#endif
+
+#ifndef DVI_CLOCK_VCO_MAX_KHZ
+#ifdef PICO_PLL_VCO_MAX_FREQ_KHZ
+#define DVI_CLOCK_VCO_MAX_KHZ PICO_PLL_VCO_MAX_FREQ_KHZ
+#else
+#define DVI_CLOCK_VCO_MAX_KHZ 1600000
+#endif
+#endif
+
+// The default voltage table starts at 1.20 V, which is what the apps here run
+// DVI at. Set this to 1 to also allow 1.10 V up to 200 MHz and 1.15 V up to
+// 260 MHz. Those points are not characterised, so check them on your boards.
+#ifndef DVI_CLOCK_VREG_BELOW_1V2
+#define DVI_CLOCK_VREG_BELOW_1V2 0
+#endif
+
+struct dvi_pll_cfg {
+	uint32_t vco_khz;
+	uint8_t postdiv1;
+	uint8_t postdiv2;
+};
+
+// Find the system PLL settings whose output is closest to target_khz, and
+// return that output frequency in kHz. cfg may be NULL. Ties go to the lower
+// output frequency, then to the lower VCO frequency, which uses less power.
+// Returns 0 if nothing is in range.
+uint32_t dvi_clock_pll_nearest_khz(uint32_t target_khz, struct dvi_pll_cfg *cfg);
+
+// Frame rate in millihertz for timing t with the given bit clock
+uint32_t dvi_clock_refresh_mhz(const struct dvi_timing *t, uint32_t bit_clk_khz);
+
+#if !PICO_NO_HARDWARE
+
+// Characterisation table for the core voltage: each entry is the highest
+// clk_sys known to work at that voltage. Entries must be in ascending order.
+struct dvi_clock_vreg_point {
+	uint32_t max_khz;
+	enum vreg_voltage vsel;
+};
+
+// Default table, from the voltages the apps in this repository have been run
+// at. It is on the cautious side; pass your own table if you have
+// characterised your boards.
+extern const struct dvi_clock_vreg_point dvi_clock_vreg_default[];
+extern const uint dvi_clock_vreg_default_count;
+
+struct dvi_clock_solution {
+	struct dvi_pll_cfg pll;
+	uint32_t sys_khz;
+	enum vreg_voltage vsel;
+	// Refresh rate at sys_khz / clk_div, and how far it is from the timing's
+	// nominal rate at bit_clk_khz
+	uint32_t refresh_mhz;
+	int32_t refresh_error_ppm;
+};
+
+// Find the clk_sys closest to clk_div times t->bit_clk_khz, and the lowest
+// core voltage the table allows at that frequency. clk_div is the
+// serialiser's clock divider (see struct dvi_serialiser_cfg), 0 or 1 for
+// clk_sys == bit clock. vreg_table may be NULL for dvi_clock_vreg_default.
+// Returns false if the nearest frequency is more than tolerance_ppm away, or
+// above the top of the table.
+bool dvi_clock_solve(const struct dvi_timing *t, uint clk_div, uint32_t tolerance_ppm,
+	const struct dvi_clock_vreg_point *vreg_table, uint n_vreg, struct dvi_clock_solution *sol);
+
+// Set the core voltage and then clk_sys. Call this at startup, before
+// anything else depends on clk_sys (including the UART). The voltage is
+// set first, so this is only safe if clk_sys is currently no higher than
+// the new setting supports.
+void dvi_clock_apply(const struct dvi_clock_solution *sol);
+
+#endif // !PICO_NO_HARDWARE
+
+#endif
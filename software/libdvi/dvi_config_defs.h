@@ -11,6 +11,12 @@
 #include "hardware/platform_defs.h"
 #include "pico/config.h"
 
+// Optional header of overrides, e.g. the one generated by
+// scripts/tmds_autotune. Set this to a quoted file name.
+#ifdef DVI_TUNED_CONFIG_HEADER
+#include DVI_TUNED_CONFIG_HEADER
+#endif
+
 // ----------------------------------------------------------------------------
 // General DVI defines
 
@@ -35,7 +41,8 @@
 // If 1, the same TMDS symbols are sent to all 3 lanes during the horizontal
 // active period. This means only monochrome colour is available, but the TMDS
 // buffers are 3 times smaller as a result, and the performance requirements
-// for encode are also cut by 3.
+// for encode are also cut by 3. See the tmds_encode_grey_* functions for
+// 4bpp and 8bpp greyscale.
 #ifndef DVI_MONOCHROME_TMDS
 #define DVI_MONOCHROME_TMDS 0
 #endif
@@ -44,13 +51,29 @@
 // 10-bit TMDS symbols, concatenated into the lower 20 bits, least-significant
 // first. This is convenient if you are generating two or more pixels at once,
 // e.g. using the pixel-doubling TMDS encode. You can change this value to 1
-// (so each word contains 1 symbol) for e.g. full resolution RGB encode. Note
-// that this value needs to divide the DVI horizontal timings, so is limited
-// to 1 or 2.
+// (so each word contains 1 symbol) for e.g. full resolution RGB encode.
+//
+// 3 packs symbols into the lower 30 bits, which makes TMDS buffers a third
+// smaller than with 2. Only the pixel-doubled RGB encoders
+// (tmds_encode_data_channel_16bpp/8bpp/rgb888_dither) support this. The other
+// encoders expect 2 symbols per word, and calling them fails the build.
+//
+// Note that this value needs to divide all of the DVI horizontal timings
+// (checked by dvi_init(), or at build time by libdvi_check_timing() in
+// libdvi/CMakeLists.txt), which for 3 rules out most standard modes. See
+// dvi_timing_960x540p_60hz_3sym.
 #ifndef DVI_SYMBOLS_PER_WORD
 #define DVI_SYMBOLS_PER_WORD 2
 #endif
 
+// Marks the declarations of encoders which only produce 2 symbols per word,
+// so that calling one with any other DVI_SYMBOLS_PER_WORD fails the build.
+#if DVI_SYMBOLS_PER_WORD == 2
+#define __dvi_2sym_only
+#else
+#define __dvi_2sym_only __attribute__((error("requires DVI_SYMBOLS_PER_WORD == 2")))
+#endif
+
 // Implement TMDS encode with hardware encoders in SIO, instead of
 // interpolators + LUTs. The processor still has to crank the encoder, but
 // it's much faster. This still works with PIO serialisers, which can appear
@@ -63,6 +86,20 @@
 #endif
 #endif
 
+// How far (in parts per million) the bit clock, and so the refresh rate, may
+// be moved to land on a frequency the system PLL can generate. Used by
+// dvi_timing_generate(), and a sensible value for dvi_clock_solve(). The
+// default matches the +/-0.5% pixel clock tolerance CEA-861 allows.
+#ifndef DVI_CLOCK_TOLERANCE_PPM
+#define DVI_CLOCK_TOLERANCE_PPM 5000
+#endif
+
+// Size of the mode list in struct dvi_edid. Modes beyond this are dropped,
+// so this only needs raising for displays with very long CEA mode lists.
+#ifndef DVI_EDID_MAX_MODES
+#define DVI_EDID_MAX_MODES 48
+#endif
+
 // ----------------------------------------------------------------------------
 // Pixel component layout
 
@@ -136,16 +173,23 @@
 // so you can easily save 10% of encode time by bumping this. Note that body
 // will *already* produce multiple pixels, and total symbols per iteration
 // must cleanly divide symbols per scanline, else the loop won't terminate.
-// Point gun away from foot.
+// Point gun away from foot. (Or let scripts/tmds_autotune and
+// apps/encode_bench check it for you.)
 #ifndef TMDS_ENCODE_UNROLL
 #define TMDS_ENCODE_UNROLL 1
 #endif
 
-// If 1, don't save/restore the interpolators on full-resolution TMDS encode.
-// Speed hack. The TMDS code uses both interpolators, for each of the 3 data
-// channels, so this define avoids 6 save/restores per scanline.
-#ifndef TMDS_FULLRES_NO_INTERP_SAVE
-#define TMDS_FULLRES_NO_INTERP_SAVE 0
+// Channel width (1 to 8 bits) of the pixel-doubled and full-resolution TMDS
+// lookup tables. The tables are generated at build time, so these must match
+// the tables the app was built with: use libdvi_tmds_table_bits() in CMake
+// rather than setting these directly. Wider channels lose their LSBs, and
+// narrower channels don't use all of the table.
+#ifndef TMDS_TABLE_BITS
+#define TMDS_TABLE_BITS 6
+#endif
+
+#ifndef TMDS_FULLRES_TABLE_BITS
+#define TMDS_FULLRES_TABLE_BITS 6
 #endif
 
 // If 1, don't DC-balance the output of full resolution encode. Hilariously
@@ -0,0 +1,349 @@
+#include <string.h>
+#include "dvi_edid.h"
+
+// Layout is from VESA E-EDID 1.4 and CEA-861-F. Everything here is plain
+// byte crunching: see dvi_edid_i2c_transport() at the bottom for the only
+// hardware access.
+
+#define EDID_EXT_CEA 0x02
+
+#define DDC_ADDR_EDID    0x50
+#define DDC_ADDR_SEGMENT 0x30
+
+static const uint8_t edid_header[8] = {0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+
+bool dvi_edid_block_valid(const uint8_t *block, bool base) {
+	if (base && memcmp(block, edid_header, sizeof(edid_header)))
+		return false;
+	uint8_t sum = 0;
+	for (uint i = 0; i < DVI_EDID_BLOCK_SIZE; ++i)
+		sum += block[i];
+	return sum == 0;
+}
+
+uint dvi_edid_read(const struct dvi_edid_transport *ddc, uint8_t *buf, uint max_blocks) {
+	if (!max_blocks || !ddc->read(ddc->ctx, 0, 0, buf, DVI_EDID_BLOCK_SIZE) || !dvi_edid_block_valid(buf, true))
+		return 0;
+	uint n_blocks = 1 + buf[126];
+	if (n_blocks > max_blocks)
+		n_blocks = max_blocks;
+	for (uint i = 1; i < n_blocks; ++i) {
+		uint8_t *block = buf + i * DVI_EDID_BLOCK_SIZE;
+		if (!ddc->read(ddc->ctx, i / 2, (i % 2) * DVI_EDID_BLOCK_SIZE, block, DVI_EDID_BLOCK_SIZE) ||
+				!dvi_edid_block_valid(block, false))
+			return i;
+	}
+	return n_blocks;
+}
+
+// ----------------------------------------------------------------------------
+// Parsing
+
+static struct dvi_edid_mode *add_mode(struct dvi_edid *edid, uint source, uint h, uint v, uint refresh_hz) {
+	if (edid->n_modes >= DVI_EDID_MAX_MODES)
+		return NULL;
+	struct dvi_edid_mode *m = &edid->modes[edid->n_modes++];
+	memset(m, 0, sizeof(*m));
+	m->source = source;
+	m->h_active = h;
+	m->v_active = v;
+	m->refresh_hz = refresh_hz;
+	return m;
+}
+
+// Established timings I and II, MSB of byte 35 first
+static const struct {
+	uint16_t h, v;
+	uint8_t refresh_hz;
+	bool interlaced;
+} established_modes[17] = {
+	{ 720,  400, 70, false}, { 720,  400, 88, false}, { 640,  480, 60, false}, { 640,  480, 67, false},
+	{ 640,  480, 72, false}, { 640,  480, 75, false}, { 800,  600, 56, false}, { 800,  600, 60, false},
+	{ 800,  600, 72, false}, { 800,  600, 75, false}, { 832,  624, 75, false}, {1024,  768, 87, true },
+	{1024,  768, 60, false}, {1024,  768, 70, false}, {1024,  768, 75, false}, {1280, 1024, 75, false},
+	{1152,  870, 75, false},
+};
+
+static void parse_established(struct dvi_edid *edid, const uint8_t *base) {
+	uint32_t bits = (uint32_t)base[35] << 16 | (uint32_t)base[36] << 8 | base[37];
+	for (uint i = 0; i < count_of(established_modes); ++i) {
+		if (!(bits & (1u << (23 - i))))
+			continue;
+		struct dvi_edid_mode *m = add_mode(edid, DVI_EDID_ESTABLISHED,
+			established_modes[i].h, established_modes[i].v, established_modes[i].refresh_hz);
+		if (m)
+			m->interlaced = established_modes[i].interlaced;
+	}
+}
+
+static void parse_standard(struct dvi_edid *edid, const uint8_t *st) {
+	// 0x0101 (or 0x0000 from some broken displays) means unused
+	if ((st[0] == 0x01 && st[1] == 0x01) || st[0] == 0x00)
+		return;
+	uint h = (st[0] + 31) * 8;
+	uint v;
+	switch (st[1] >> 6) {
+	case 0:
+		// 1:1 before EDID 1.3
+		v = edid->version == 1 && edid->revision < 3 ? h : h * 10 / 16;
+		break;
+	case 1:
+		v = h * 3 / 4;
+		break;
+	case 2:
+		v = h * 4 / 5;
+		break;
+	default:
+		v = h * 9 / 16;
+		break;
+	}
+	add_mode(edid, DVI_EDID_STANDARD, h, v, (st[1] & 0x3f) + 60);
+}
+
+static void parse_detailed_timing(struct dvi_edid *edid, const uint8_t *d, bool preferred) {
+	uint32_t pix_khz = (d[0] | d[1] << 8) * 10;
+	uint h_active = d[2] | (d[4] & 0xf0) << 4;
+	uint h_blank  = d[3] | (d[4] & 0x0f) << 8;
+	uint v_active = d[5] | (d[7] & 0xf0) << 4;
+	uint v_blank  = d[6] | (d[7] & 0x0f) << 8;
+	uint h_fp     = d[8] | (d[11] & 0xc0) << 2;
+	uint h_sync   = d[9] | (d[11] & 0x30) << 4;
+	uint v_fp     = (d[10] >> 4) | (d[11] & 0x0c) << 2;
+	uint v_sync   = (d[10] & 0x0f) | (d[11] & 0x03) << 4;
+	if (!h_active || !v_active || h_fp + h_sync >= h_blank || v_fp + v_sync >= v_blank)
+		return;
+
+	uint h_total = h_active + h_blank;
+	uint v_total = v_active + v_blank;
+	uint refresh_hz = (uint)(((uint64_t)pix_khz * 1000 + h_total * v_total / 2) / (h_total * v_total));
+	// Interlaced vertical timings are per field, so the refresh is the field
+	// rate, but the mode is listed with the frame's height, e.g. 1920x1080i60
+	bool interlaced = d[17] & 0x80;
+	struct dvi_edid_mode *m = add_mode(edid, DVI_EDID_DETAILED, h_active, interlaced ? 2 * v_active : v_active, refresh_hz);
+	if (!m)
+		return;
+	m->preferred = preferred;
+	m->interlaced = interlaced;
+	struct dvi_timing *t = &m->detailed;
+	// Digital separate sync gives polarities in bits 2:1. Anything else
+	// (composite, analog) gets the negative polarity VGA used.
+	bool separate = (d[17] & 0x18) == 0x18;
+	t->h_sync_polarity = separate && (d[17] & 0x02);
+	t->h_front_porch   = h_fp;
+	t->h_sync_width    = h_sync;
+	t->h_back_porch    = h_blank - h_fp - h_sync;
+	t->h_active_pixels = h_active;
+
+	t->v_sync_polarity = separate && (d[17] & 0x04);
+	t->v_front_porch   = v_fp;
+	t->v_sync_width    = v_sync;
+	t->v_back_porch    = v_blank - v_fp - v_sync;
+	t->v_active_lines  = v_active;
+
+	t->interlaced      = interlaced;
+
+	t->bit_clk_khz     = 10 * pix_khz;
+}
+
+static void parse_display_descriptor(struct dvi_edid *edid, const uint8_t *d) {
+	switch (d[3]) {
+	case 0xfc: {
+		// Name, terminated by 0x0a and padded with spaces
+		uint i;
+		for (i = 0; i < 13 && d[5 + i] != 0x0a; ++i)
+			edid->name[i] = d[5 + i];
+		edid->name[i] = '\0';
+		break;
+	}
+	case 0xfd: {
+		// Range limits. In EDID 1.4, byte 4 flags add 255 to some of them.
+		edid->has_range_limits = true;
+		edid->min_v_hz = d[5] + (d[4] & 0x01 ? 255 : 0);
+		edid->max_v_hz = d[6] + (d[4] & 0x02 ? 255 : 0);
+		edid->min_h_khz = d[7] + (d[4] & 0x04 ? 255 : 0);
+		edid->max_h_khz = d[8] + (d[4] & 0x08 ? 255 : 0);
+		edid->max_pixel_khz = d[9] * 10000;
+		// CVT support information, with the blanking types in byte 15
+		if (d[10] == 0x04)
+			edid->cvt_rb = d[15] & 0x10;
+		break;
+	}
+	case 0xfa:
+		// Six more standard timings
+		for (uint i = 0; i < 6; ++i)
+			parse_standard(edid, d + 5 + 2 * i);
+		break;
+	default:
+		break;
+	}
+}
+
+static void parse_descriptor(struct dvi_edid *edid, const uint8_t *d, bool preferred) {
+	if (d[0] || d[1])
+		parse_detailed_timing(edid, d, preferred);
+	else
+		parse_display_descriptor(edid, d);
+}
+
+static void parse_cea(struct dvi_edid *edid, const uint8_t *ext) {
+	uint dtd_offset = ext[2];
+	if (dtd_offset >= 4 && dtd_offset <= DVI_EDID_BLOCK_SIZE - 1) {
+		// Data block collection between byte 4 and the first DTD
+		for (uint i = 4; i < dtd_offset;) {
+			uint tag = ext[i] >> 5;
+			uint len = ext[i] & 0x1f;
+			const uint8_t *payload = ext + i + 1;
+			if (i + 1 + len > dtd_offset)
+				break;
+			if (tag == 2) {
+				// Video data block: one short video descriptor per byte. Bit 7
+				// flags a native mode for VICs 1 to 64.
+				for (uint j = 0; j < len; ++j) {
+					uint svd = payload[j];
+					uint vic = svd >= 129 && svd <= 192 ? svd & 0x7f : svd;
+					uint h, v, refresh_hz;
+					if (!dvi_timing_cea_vic_mode(vic, &h, &v, &refresh_hz))
+						continue;
+					struct dvi_edid_mode *m = add_mode(edid, DVI_EDID_CEA_VIC, h, v, refresh_hz);
+					if (m)
+						m->vic = vic;
+				}
+			}
+			else if (tag == 3 && len >= 3) {
+				// HDMI Licensing OUI 00-0C-03, little-endian
+				if (payload[0] == 0x03 && payload[1] == 0x0c && payload[2] == 0x00)
+					edid->hdmi = true;
+			}
+			i += 1 + len;
+		}
+	}
+	if (dtd_offset) {
+		for (uint i = dtd_offset; i + 18 <= DVI_EDID_BLOCK_SIZE - 1; i += 18) {
+			if (!ext[i] && !ext[i + 1])
+				break;
+			parse_detailed_timing(edid, ext + i, false);
+		}
+	}
+}
+
+bool dvi_edid_parse(const uint8_t *data, uint n_blocks, struct dvi_edid *edid) {
+	memset(edid, 0, sizeof(*edid));
+	if (!n_blocks || !dvi_edid_block_valid(data, true))
+		return false;
+	edid->version = data[18];
+	edid->revision = data[19];
+	// Three 5-bit letters, 'A' == 1
+	uint16_t mfg = data[8] << 8 | data[9];
+	edid->mfg_id[0] = '@' + ((mfg >> 10) & 0x1f);
+	edid->mfg_id[1] = '@' + ((mfg >> 5) & 0x1f);
+	edid->mfg_id[2] = '@' + (mfg & 0x1f);
+	edid->product_code = data[10] | data[11] << 8;
+	edid->digital = data[20] & 0x80;
+
+	// Detailed timings first, so the preferred mode is modes[0] if present.
+	// The first descriptor is the preferred mode since EDID 1.3 (and in
+	// practice before).
+	for (uint i = 0; i < 4; ++i)
+		parse_descriptor(edid, data + 54 + 18 * i, i == 0);
+	parse_established(edid, data);
+	for (uint i = 0; i < 8; ++i)
+		parse_standard(edid, data + 38 + 2 * i);
+
+	for (uint b = 1; b < n_blocks; ++b) {
+		const uint8_t *ext = data + b * DVI_EDID_BLOCK_SIZE;
+		if (ext[0] == EDID_EXT_CEA && dvi_edid_block_valid(ext, false))
+			parse_cea(edid, ext);
+	}
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+// Mode selection
+
+static bool within_range_limits(const struct dvi_edid *edid, const struct dvi_timing *t) {
+	if (!edid->has_range_limits)
+		return true;
+	uint32_t pix_khz = t->bit_clk_khz / 10;
+	uint h_total = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+	uint32_t h_khz = pix_khz / h_total;
+	uint32_t v_hz = (dvi_timing_refresh_mhz(t) + 500) / 1000;
+	return pix_khz <= edid->max_pixel_khz &&
+		h_khz >= edid->min_h_khz && h_khz <= edid->max_h_khz &&
+		v_hz >= edid->min_v_hz && v_hz <= edid->max_v_hz;
+}
+
+// Which of method_mask's methods can generate a timing for mode m. Detailed
+// timings don't need generating, so get a single pass (bit 0).
+static uint mode_methods(const struct dvi_edid *edid, const struct dvi_edid_mode *m, uint method_mask) {
+	if (m->source == DVI_EDID_DETAILED)
+		return 1;
+	if (m->source == DVI_EDID_CEA_VIC)
+		method_mask &= 1u << DVI_TIMING_CEA;
+	if (!edid->cvt_rb)
+		method_mask &= ~(1u << DVI_TIMING_CVT_RB);
+	return method_mask;
+}
+
+static bool mode_timing(const struct dvi_edid_mode *m, enum dvi_timing_method method, struct dvi_timing *t) {
+	if (m->source == DVI_EDID_DETAILED) {
+		*t = m->detailed;
+		return dvi_timing_fit(t, m->detailed.bit_clk_khz / 10);
+	}
+	return dvi_timing_generate(t, method, m->h_active, m->v_active, m->refresh_hz);
+}
+
+bool dvi_edid_select_timing(const struct dvi_edid *edid, uint h_active, uint v_active, uint method_mask,
+		uint32_t max_bit_clk_khz, struct dvi_timing *t) {
+	bool found = false;
+	bool found_preferred = false;
+	for (uint i = 0; i < edid->n_modes; ++i) {
+		const struct dvi_edid_mode *m = &edid->modes[i];
+		if ((m->interlaced && m->source != DVI_EDID_DETAILED) || (h_active && m->h_active != h_active) || (v_active && m->v_active != v_active))
+			continue;
+		// Try every method rather than just the lowest clock, as e.g. CVT
+		// 640x480p60 is below most monitors' minimum line rate, but the CEA
+		// timing for the same mode is fine.
+		uint methods = mode_methods(edid, m, method_mask);
+		for (uint method = 0; method < DVI_TIMING_METHOD_COUNT; ++method) {
+			struct dvi_timing candidate;
+			if (!(methods & (1u << method)) || !mode_timing(m, method, &candidate) || candidate.bit_clk_khz > max_bit_clk_khz)
+				continue;
+			// The display's own detailed timings are by definition in range
+			if (m->source != DVI_EDID_DETAILED && !within_range_limits(edid, &candidate))
+				continue;
+			if (!found || candidate.bit_clk_khz < t->bit_clk_khz ||
+					(candidate.bit_clk_khz == t->bit_clk_khz && m->preferred && !found_preferred)) {
+				*t = candidate;
+				found = true;
+				found_preferred = m->preferred;
+			}
+		}
+	}
+	return found;
+}
+
+// ----------------------------------------------------------------------------
+// I2C transport
+
+#if !PICO_NO_HARDWARE
+
+static bool ddc_i2c_read(void *ctx, uint segment, uint offset, uint8_t *buf, uint len) {
+	i2c_inst_t *i2c = (i2c_inst_t*)ctx;
+	// E-DDC segment pointer, only needed beyond the first two blocks. Displays
+	// without it NAK, which is fine as they have no more blocks anyway.
+	if (segment) {
+		uint8_t seg = segment;
+		if (i2c_write_blocking(i2c, DDC_ADDR_SEGMENT, &seg, 1, true) != 1)
+			return false;
+	}
+	uint8_t offs = offset;
+	if (i2c_write_blocking(i2c, DDC_ADDR_EDID, &offs, 1, true) != 1)
+		return false;
+	return i2c_read_blocking(i2c, DDC_ADDR_EDID, buf, len, false) == (int)len;
+}
+
+struct dvi_edid_transport dvi_edid_i2c_transport(i2c_inst_t *i2c) {
+	return (struct dvi_edid_transport){.read = ddc_i2c_read, .ctx = i2c};
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef _DVI_EDID_H
+#define _DVI_EDID_H
+
+#include "pico/types.h"
+#include "dvi_config_defs.h"
+#include "dvi_timing_gen.h"
+
+// EDID parsing, and choosing the cheapest mode a display accepts. The parser
+// and selector have no hardware dependencies, and also build for the host
+// (PICO_NO_HARDWARE) so they can be tested against EDID dumps. Only the I2C
+// DDC transport needs real hardware.
+//
+// Typical use at boot:
+//
+//   uint8_t raw[4 * DVI_EDID_BLOCK_SIZE];
+//   static struct dvi_edid edid;
+//   struct dvi_edid_transport ddc = dvi_edid_i2c_transport(i2c0);
+//   uint n = dvi_edid_read(&ddc, raw, 4);
+//   struct dvi_timing timing;
+//   if (!n || !dvi_edid_parse(raw, n, &edid) ||
+//       !dvi_edid_select_timing(&edid, 640, 480, DVI_TIMING_METHODS_ALL, 320000, &timing))
+//       timing = dvi_timing_640x480p_60hz;
+//
+// and then pass the timing to dvi_clock_solve().
+
+#define DVI_EDID_BLOCK_SIZE 128
+
+// Read len bytes from byte offset within a 256-byte EDID segment (two
+// blocks). Returns false on a bus error or NAK.
+struct dvi_edid_transport {
+	bool (*read)(void *ctx, uint segment, uint offset, uint8_t *buf, uint len);
+	void *ctx;
+};
+
+enum dvi_edid_mode_source {
+	DVI_EDID_DETAILED,    // Detailed timing descriptor: exact timing is known
+	DVI_EDID_ESTABLISHED, // Established timings bitmap
+	DVI_EDID_STANDARD,    // Standard timing: resolution and refresh only
+	DVI_EDID_CEA_VIC      // CEA extension short video descriptor
+};
+
+struct dvi_edid_mode {
+	uint16_t h_active;
+	uint16_t v_active;
+	uint8_t refresh_hz;
+	uint8_t source;
+	uint8_t vic;
+	bool preferred;
+	bool interlaced;
+	// DVI_EDID_DETAILED only. detailed.bit_clk_khz is 10 times the display's
+	// pixel clock, not yet snapped to the PLL.
+	struct dvi_timing detailed;
+};
+
+struct dvi_edid {
+	uint8_t version;
+	uint8_t revision;
+	char mfg_id[4];
+	uint16_t product_code;
+	char name[14];
+	bool digital;
+	// HDMI vendor block present in the CEA extension
+	bool hdmi;
+	// From the range limits descriptor, if has_range_limits
+	bool has_range_limits;
+	bool cvt_rb;
+	uint16_t min_v_hz;
+	uint16_t max_v_hz;
+	uint16_t min_h_khz;
+	uint16_t max_h_khz;
+	uint32_t max_pixel_khz;
+
+	uint n_modes;
+	struct dvi_edid_mode modes[DVI_EDID_MAX_MODES];
+};
+
+// Check the header (base block only) and checksum of a 128-byte block
+bool dvi_edid_block_valid(const uint8_t *block, bool base);
+
+// Read the base block and as many extension blocks as fit in max_blocks.
+// Returns the number of valid blocks read, or 0 if the base block couldn't
+// be read.
+uint dvi_edid_read(const struct dvi_edid_transport *ddc, uint8_t *buf, uint max_blocks);
+
+// Parse n_blocks of EDID, base block first. Extensions other than CEA-861
+// are skipped. Returns false if the base block is invalid.
+bool dvi_edid_parse(const uint8_t *data, uint n_blocks, struct dvi_edid *edid);
+
+// Go through the display's modes and pick the one with the lowest bit clock
+// which:
+// - has the requested h_active and v_active (0 for don't care)
+// - libdvi can generate (see dvi_timing_generate() and dvi_timing_fit())
+//   using the methods in method_mask, plus the display's own detailed
+//   timings. CVT-RB is only used if the display advertises it, but a caller
+//   which knows better can set edid->cvt_rb.
+// - is within the display's range limits, if it has any
+// - needs a bit clock no higher than max_bit_clk_khz
+// Interlaced modes are only used if the display gives a detailed timing for
+// them. Ties go to the display's preferred mode.
+bool dvi_edid_select_timing(const struct dvi_edid *edid, uint h_active, uint v_active, uint method_mask,
+	uint32_t max_bit_clk_khz, struct dvi_timing *t);
+
+#if !PICO_NO_HARDWARE
+#include "hardware/i2c.h"
+
+// DDC over one of the I2C blocks. The caller sets up the pins (with
+// pull-ups) and calls i2c_init() first, at no more than 100 kHz.
+struct dvi_edid_transport dvi_edid_i2c_transport(i2c_inst_t *i2c);
+#endif
+
+#endif
@@ -27,6 +27,8 @@ void dvi_serialiser_init(struct dvi_serialiser_cfg *cfg) {
 	uint offset = pio_add_program(cfg->pio, &dvi_serialiser_program);
 #endif
 	cfg->prog_offs = offset;
+	uint clk_div = cfg->clk_div ? cfg->clk_div : 1;
+	assert(clk_div <= 255);
 
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
 		pio_sm_claim(cfg->pio, cfg->sm_tmds[i]);
@@ -35,6 +37,7 @@ void dvi_serialiser_init(struct dvi_serialiser_cfg *cfg) {
 			cfg->sm_tmds[i],
 			offset,
 			cfg->pins_tmds[i],
+			clk_div,
 			DVI_SERIAL_DEBUG
 		);
 		dvi_configure_pad(cfg->pins_tmds[i], cfg->invert_diffpairs);
@@ -45,9 +48,12 @@ void dvi_serialiser_init(struct dvi_serialiser_cfg *cfg) {
 	// slice (lower-numbered GPIO must be even).
 	assert(cfg->pins_clk % 2 == 0);
 	uint slice = pwm_gpio_to_slice_num(cfg->pins_clk);
-	// 5 cycles high, 5 low. Invert one channel so that we get complementary outputs.
+	// 5 bit periods high, 5 low. Invert one channel so that we get complementary
+	// outputs. Same integer divider as the serialisers, so the pixel clock stays
+	// locked to the bit clock.
 	pwm_config pwm_cfg = pwm_get_default_config();
 	pwm_config_set_output_polarity(&pwm_cfg, true, false);
+	pwm_config_set_clkdiv_int(&pwm_cfg, clk_div);
 	pwm_config_set_wrap(&pwm_cfg, 9);
 	pwm_init(slice, &pwm_cfg, false);
 	pwm_set_both_levels(slice, 5, 5);
@@ -59,17 +65,19 @@ void dvi_serialiser_init(struct dvi_serialiser_cfg *cfg) {
 }
 
 void dvi_serialiser_enable(struct dvi_serialiser_cfg *cfg, bool enable) {
-	uint mask = 0;
+	uint sm_mask = 0;
 	for (int i = 0; i < N_TMDS_LANES; ++i)
-		mask |= 1u << (cfg->sm_tmds[i] + PIO_CTRL_SM_ENABLE_LSB);
+		sm_mask |= 1u << cfg->sm_tmds[i];
 	if (enable) {
 		// The DVI spec allows for phase offset between clock and data links.
-		// So PWM and PIO do not need to be synchronised perfectly.
-		hw_set_bits(&cfg->pio->ctrl, mask);
+		// So PWM and PIO do not need to be synchronised perfectly. The lanes
+		// restart their clock dividers together, so that a clk_div > 1 doesn't
+		// skew them against each other by up to a bit period.
+		hw_set_bits(&cfg->pio->ctrl, (sm_mask << PIO_CTRL_SM_ENABLE_LSB) | (sm_mask << PIO_CTRL_CLKDIV_RESTART_LSB));
 		pwm_set_enabled(pwm_gpio_to_slice_num(cfg->pins_clk), true);
 	}
 	else {
-		hw_clear_bits(&cfg->pio->ctrl, mask);
+		hw_clear_bits(&cfg->pio->ctrl, sm_mask << PIO_CTRL_SM_ENABLE_LSB);
 		pwm_set_enabled(pwm_gpio_to_slice_num(cfg->pins_clk), false);
 	}
 }
@@ -12,6 +12,11 @@ struct dvi_serialiser_cfg {
 	uint pins_tmds[N_TMDS_LANES];
 	uint pins_clk;
 	bool invert_diffpairs;
+	// Integer divider from clk_sys to the TMDS bit clock, applied to the PIO
+	// state machines and the clock PWM alike. 0 or 1 means clk_sys is the bit
+	// clock, as usual. A higher divider lets the cores run faster than the
+	// bit clock, so encode gets proportionally more cycles per scanline.
+	uint clk_div;
 	uint prog_offs;
 };
 
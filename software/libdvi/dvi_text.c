@@ -0,0 +1,123 @@
+#include <string.h>
+#include "dvi_text.h"
+#include "tmds_encode.h"
+#include "tmds_encode_font_2bpp.h"
+
+// Text mode encode produces two symbols per word (see __dvi_2sym_only)
+#if DVI_SYMBOLS_PER_WORD == 2
+
+static const uint8_t dvi_text_default_palette[16] = {
+	0x00, 0x02, 0x08, 0x0a, 0x20, 0x22, 0x24, 0x2a,
+	0x15, 0x17, 0x1d, 0x1f, 0x35, 0x37, 0x3d, 0x3f
+};
+
+void dvi_text_init(struct dvi_text *text, const struct dvi_text_font *font, uint cols, uint rows, uint attr_bits,
+		const uint8_t *charbuf, const uint8_t *attrbuf, const uint8_t *flagbuf) {
+	assert(font->width == 8 || font->width == 16);
+	assert(attr_bits == 4 || attr_bits == 8);
+	assert(cols <= DVI_TEXT_MAX_COLS);
+	text->font = font;
+	text->cols = cols;
+	text->rows = rows;
+	text->attr_bits = attr_bits;
+	text->charbuf = charbuf;
+	text->attrbuf = attrbuf;
+	text->flagbuf = flagbuf;
+	memcpy(text->palette, dvi_text_default_palette, sizeof(text->palette));
+	text->underline_row = font->height - 1;
+	text->blink_shift = 5;
+	text->frame = 0;
+	text->resolved_key = -1;
+}
+
+// Work out the 2-bit fg/bg levels of each cell on one lane, packed 8 cells
+// per word in the format expected by tmds_encode_font_2bpp().
+static void __not_in_flash_func(dvi_text_resolve_row)(struct dvi_text *text, uint row, bool underline, bool blink_off) {
+	const uint words_per_lane = (text->cols + 7) / 8;
+	memset(text->colourbuf, 0, N_TMDS_LANES * words_per_lane * sizeof(uint32_t));
+	const uint idx_mask = text->attr_bits == 8 ? 0xf : 0x3;
+	for (uint x = 0; x < text->cols; ++x) {
+		uint cell = row * text->cols + x;
+		uint attr = text->attr_bits == 8 ? text->attrbuf[cell] :
+			(text->attrbuf[cell / 2] >> (cell % 2 * 4)) & 0xf;
+		uint fg = attr & idx_mask;
+		uint bg = (attr >> (text->attr_bits / 2)) & idx_mask;
+		if (text->flagbuf) {
+			uint flags = text->flagbuf[cell];
+			if (flags & DVI_TEXT_INVERSE) {
+				uint tmp = fg;
+				fg = bg;
+				bg = tmp;
+			}
+			if ((flags & DVI_TEXT_BLINK) && blink_off)
+				fg = bg;
+			else if ((flags & DVI_TEXT_UNDERLINE) && underline)
+				bg = fg;
+		}
+		uint fg_rgb = text->palette[fg];
+		uint bg_rgb = text->palette[bg];
+		for (uint lane = 0; lane < N_TMDS_LANES; ++lane) {
+			uint pair = ((fg_rgb >> (2 * lane)) & 0x3) | (((bg_rgb >> (2 * lane)) & 0x3) << 2);
+			text->colourbuf[lane * words_per_lane + x / 8] |= pair << (x % 8 * 4);
+		}
+	}
+}
+
+void __not_in_flash_func(dvi_text_render_scanline)(struct dvi_text *text, uint y, uint32_t *tmdsbuf, uint n_pix) {
+	const struct dvi_text_font *font = text->font;
+	uint row = y / font->height;
+	if (row >= text->rows) {
+		// Below the last text row (e.g. 600 lines of a 16-line font): fill
+		// with palette entry 0, expanded from RGB222 to RGB888.
+		uint c = text->palette[0];
+		uint32_t rgb = ((c & 0x3) | (c & 0xc) << 6 | (c & 0x30) << 12) * 0x55;
+		tmds_encode_solid_rgb888(rgb, tmdsbuf, n_pix, N_TMDS_LANES);
+		return;
+	}
+	uint font_row = y % font->height;
+	bool underline = font_row == text->underline_row;
+	bool blink_off = (text->frame >> text->blink_shift) & 1;
+	int key = (row << 2) | (underline << 1) | blink_off;
+	if (key != text->resolved_key) {
+		dvi_text_resolve_row(text, row, underline, blink_off);
+		text->resolved_key = key;
+	}
+
+	const uint8_t *charbuf = &text->charbuf[row * text->cols];
+	const uint words_per_lane = (text->cols + 7) / 8;
+	const uint text_pix = text->cols * font->width;
+	for (uint lane = 0; lane < N_TMDS_LANES; ++lane) {
+		uint32_t *lane_tmdsbuf = tmdsbuf + lane * (n_pix / DVI_SYMBOLS_PER_WORD);
+		const uint32_t *colourbuf = &text->colourbuf[lane * words_per_lane];
+		if (font->width == 16) {
+			const uint16_t *font_line = (const uint16_t*)font->bitmap + font_row * font->n_chars - font->first_char;
+			tmds_encode_font16_2bpp(charbuf, colourbuf, lane_tmdsbuf, text_pix, font_line);
+		}
+		else {
+			const uint8_t *font_line = (const uint8_t*)font->bitmap + font_row * font->n_chars - font->first_char;
+			tmds_encode_font_2bpp(charbuf, colourbuf, lane_tmdsbuf, text_pix, font_line);
+		}
+	}
+}
+
+void __not_in_flash_func(dvi_text_main)(struct dvi_inst *inst, struct dvi_text *text) {
+	const uint n_pix = inst->timing->h_active_pixels;
+	const uint n_lines = inst->timing->v_active_lines / DVI_VERTICAL_REPEAT;
+	assert(text->cols * text->font->width == n_pix);
+	assert(text->rows * text->font->height <= n_lines);
+	uint y = 0;
+	while (1) {
+		uint32_t *tmdsbuf;
+		queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		dvi_text_render_scanline(text, y, tmdsbuf, n_pix);
+		queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+		++y;
+		if (y == n_lines) {
+			y = 0;
+			dvi_text_next_frame(text);
+		}
+	}
+	__builtin_unreachable();
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef _DVI_TEXT_H
+#define _DVI_TEXT_H
+
+#include "pico/types.h"
+#include "dvi.h"
+
+// Text mode: encode TMDS scanlines straight from a character buffer and an
+// attribute buffer, with no framebuffer in between. Built on
+// tmds_encode_font_2bpp(), so colours are RGB222 (the per-lane LUT is 2 kB,
+// and is shared by all three lanes), and the whole encode fits on one core at
+// the usual clk_sys == bit clock.
+//
+// Each cell has a foreground and background colour, as either a 4-bit
+// attribute (2-bit fg/bg index, two cells per byte, low nibble first) or an
+// 8-bit attribute (4-bit fg/bg index). Foreground is in the LSBs. The indices
+// go through a palette of RGB222 colours.
+//
+// Optionally each cell also has DVI_TEXT_* flags. These are applied as colour
+// changes, not pixel changes, so they cost nothing per pixel:
+//
+// - Underline: on the underline row of the font, the cell is all foreground
+// - Inverse: swap foreground and background
+// - Blink: for half of each blink period, the cell is all background
+//
+// Colours are resolved once per character row (and again for the underline
+// row and when the blink phase changes), so there is a little extra work on
+// those scanlines.
+
+#ifndef DVI_TEXT_MAX_COLS
+#define DVI_TEXT_MAX_COLS 160
+#endif
+
+#define DVI_TEXT_UNDERLINE 0x1u
+#define DVI_TEXT_INVERSE   0x2u
+#define DVI_TEXT_BLINK     0x4u
+
+// Font bitmap layout is row 0 of every character, then row 1, and so on.
+// Each row is one byte for 8px-wide fonts, and one halfword for 16px-wide
+// fonts, with the leftmost pixel in the LSB. (Same as assets/font_8x8.h)
+struct dvi_text_font {
+	const void *bitmap;
+	uint8_t width;
+	uint8_t height;
+	uint8_t first_char;
+	uint16_t n_chars;
+};
+
+struct dvi_text {
+	// Config ---
+	const struct dvi_text_font *font;
+	uint cols;
+	uint rows;
+	uint attr_bits;
+	// One byte per cell
+	const uint8_t *charbuf;
+	// attr_bits per cell
+	const uint8_t *attrbuf;
+	// One byte per cell, or NULL if no cells have flags
+	const uint8_t *flagbuf;
+	// RGB222 colours, blue in the LSBs
+	uint8_t palette[16];
+	// Font row which is replaced by the underline
+	uint8_t underline_row;
+	// Blink period is 2 ^ (blink_shift + 1) frames
+	uint8_t blink_shift;
+
+	// State ---
+	uint frame;
+	int resolved_key;
+	uint32_t colourbuf[N_TMDS_LANES * DVI_TEXT_MAX_COLS / 8];
+};
+
+// Fill in defaults: CGA-ish palette, underline on the last font row, blink
+// roughly once a second at 60 Hz. cols * font->width should be the display
+// width, and charbuf/attrbuf must be word-aligned.
+__dvi_2sym_only void dvi_text_init(struct dvi_text *text, const struct dvi_text_font *font, uint cols, uint rows, uint attr_bits,
+	const uint8_t *charbuf, const uint8_t *attrbuf, const uint8_t *flagbuf);
+
+// Encode display line y into tmdsbuf, which has room for n_pix pixels per lane.
+// Lines below the last text row are filled with palette entry 0.
+__dvi_2sym_only void dvi_text_render_scanline(struct dvi_text *text, uint y, uint32_t *tmdsbuf, uint n_pix);
+
+// Call after the last scanline of each frame, to advance the blink phase.
+static inline void dvi_text_next_frame(struct dvi_text *text) {
+	++text->frame;
+}
+
+// TMDS encode worker function: core enters and doesn't leave, but still
+// responds to IRQs. Renders each scanline from the text buffers and passes it
+// to the tmds valid queue.
+__dvi_2sym_only void dvi_text_main(struct dvi_inst *inst, struct dvi_text *text);
+
+#endif
@@ -117,6 +117,25 @@ const struct dvi_timing __dvi_const(dvi_timing_960x540p_60hz) = {
 	.bit_clk_khz       = 372000
 };
 
+// As above, with the front porch and sync shuffled by one pixel so that all
+// horizontal timings divide by 3, for DVI_SYMBOLS_PER_WORD == 3. Same line
+// length, so same pixel clock and refresh.
+const struct dvi_timing __dvi_const(dvi_timing_960x540p_60hz_3sym) = {
+	.h_sync_polarity   = true,
+	.h_front_porch     = 15,
+	.h_sync_width      = 33,
+	.h_back_porch      = 96,
+	.h_active_pixels   = 960,
+
+	.v_sync_polarity   = true,
+	.v_front_porch     = 2,
+	.v_sync_width      = 6,
+	.v_back_porch      = 15,
+	.v_active_lines    = 540,
+
+	.bit_clk_khz       = 372000
+};
+
 // Note this is NOT the correct 720p30 CEA mode, but rather 720p60 run at half
 // pixel clock. Seems to be commonly accepted (and is a valid CVT mode). The
 // actual CEA mode is the same pixel clock as 720p60 but with >50% blanking,
@@ -156,6 +175,50 @@ const struct dvi_timing __dvi_const(dvi_timing_1280x720p_reduced_30hz) = {
 	.bit_clk_khz       = 319200
 };
 
+// 480i 60 Hz (CEA VIC 6), as a 720 pixel framebuffer with the usual pixel
+// doubling. Same 270 MHz bit clock as 480p, with lines twice as long, so the
+// encode cost per framebuffer pixel is also the same. v_* are per field: the
+// odd field has an extra half line at each end of vsync, for 525 lines per
+// frame.
+const struct dvi_timing __dvi_const(dvi_timing_1440x480i_60hz) = {
+	.h_sync_polarity   = false,
+	.h_front_porch     = 38,
+	.h_sync_width      = 124,
+	.h_back_porch      = 114,
+	.h_active_pixels   = 1440,
+
+	.v_sync_polarity   = false,
+	.v_front_porch     = 4,
+	.v_sync_width      = 3,
+	.v_back_porch      = 15,
+	.v_active_lines    = 240,
+
+	.interlaced        = true,
+
+	.bit_clk_khz       = 270000
+};
+
+// Like 720p30, this is NOT a CEA mode, but 1080i60 run at half pixel clock,
+// i.e. 30 fields per second. The real thing needs 742 MHz. Same clk_sys as
+// 720p30, and it isn't a given that a display will take it.
+const struct dvi_timing __dvi_const(dvi_timing_1920x1080i_30hz) = {
+	.h_sync_polarity   = true,
+	.h_front_porch     = 88,
+	.h_sync_width      = 44,
+	.h_back_porch      = 148,
+	.h_active_pixels   = 1920,
+
+	.v_sync_polarity   = true,
+	.v_front_porch     = 2,
+	.v_sync_width      = 5,
+	.v_back_porch      = 15,
+	.v_active_lines    = 540,
+
+	.interlaced        = true,
+
+	.bit_clk_khz       = 372000
+};
+
 // This requires a spicy 488 MHz system clock and is illegal in most countries
 // (you need to have a very lucky piece of silicon to run this at 1.3 V, or
 // connect an external supply and give it a bit more juice)
@@ -208,13 +271,15 @@ const struct dvi_timing __dvi_const(dvi_timing_1600x900p_reduced_30hz) = {
 // four regular IRQs per scanline and return early from 3 of them, but this
 // breaks down when you have very short scanline sections like guard bands.
 
-// Each symbol appears twice, concatenated in one word. Note these must be in
-// RAM because they see a lot of DMA traffic
+// Each symbol appears three times, concatenated in one word, so the same
+// table works for any DVI_SYMBOLS_PER_WORD (the serialiser discards the
+// unused upper bits). Note these must be in RAM because they see a lot of DMA
+// traffic
 const uint32_t __dvi_const(dvi_ctrl_syms)[4] = {
-	0xd5354,
-	0x2acab,
-	0x55154,
-	0xaaeab
+	0x354d5354,
+	0x0ab2acab,
+	0x15455154,
+	0x2abaaeab
 };
 
 // Output solid red scanline if we are given NULL for tmdsbuff
@@ -224,26 +289,42 @@ static uint32_t __dvi_const(empty_scanline_tmds)[3] = {
 	0x7fd00u, // 0x00, 0x00
 	0xbfa01u  // 0xfc, 0xfc
 };
+#define EMPTY_SCANLINE_WORDS_PER_LANE 1
+#elif DVI_SYMBOLS_PER_WORD == 3
+// Symbol pairs straddle words, so the pattern repeats every 2 words
+static uint32_t __attribute__((aligned(8))) __dvi_const(empty_scanline_tmds)[6] = {
+	0x1007fd00u, 0x1ff401ffu, // 0x00, 0x00
+	0x1007fd00u, 0x1ff401ffu, // 0x00, 0x00
+	0x201bfa01u, 0x2fe806feu  // 0xfc, 0xfc
+};
+#define EMPTY_SCANLINE_WORDS_PER_LANE 2
 #else
 static uint32_t __attribute__((aligned(8))) __dvi_const(empty_scanline_tmds)[6] = {
 	0x100u, 0x1ffu, // 0x00, 0x00
 	0x100u, 0x1ffu, // 0x00, 0x00
 	0x201u, 0x2feu  // 0xfc, 0xfc
 };
+#define EMPTY_SCANLINE_WORDS_PER_LANE 2
 #endif
 
 void dvi_timing_state_init(struct dvi_timing_state *t) {
 	t->v_ctr = 0;
 	t->v_state = DVI_STATE_FRONT_PORCH;
+	t->field = 0;
 }
 
+// For interlaced timings, the odd field's vsync starts half way along its
+// first line and ends half way along an extra line, so that field's SYNC
+// state is one line longer. (field is always 0 for progressive timings.)
 void __dvi_func(dvi_timing_state_advance)(const struct dvi_timing *t, struct dvi_timing_state *s) {
 		s->v_ctr++;
 		if ((s->v_state == DVI_STATE_FRONT_PORCH && s->v_ctr == t->v_front_porch) || 
-		    (s->v_state == DVI_STATE_SYNC && s->v_ctr == t->v_sync_width) ||
+		    (s->v_state == DVI_STATE_SYNC && s->v_ctr == t->v_sync_width + s->field) ||
 		    (s->v_state == DVI_STATE_BACK_PORCH && s->v_ctr == t->v_back_porch) ||
 		    (s->v_state == DVI_STATE_ACTIVE && s->v_ctr == t->v_active_lines)) {
 
+			if (s->v_state == DVI_STATE_ACTIVE && t->interlaced)
+				s->field ^= 1;
 			s->v_state = (s->v_state + 1) % DVI_STATE_COUNT;
 			s->v_ctr = 0;
 		}
@@ -281,7 +362,7 @@ void dvi_setup_scanline_for_vblank(const struct dvi_timing *t, const struct dvi_
 	const uint32_t *sym_no_sync   = get_ctrl_sym(false,  false             );
 
 	dma_cb_t *synclist = dvi_lane_from_list(l, TMDS_SYNC_LANE);
-	// The symbol table contains each control symbol *twice*, concatenated into 20 LSBs of table word, so we can always do word-repeat.
+	// The symbol table contains each control symbol three times, concatenated into 30 LSBs of table word, so we can always do word-repeat.
 	_set_data_cb(&synclist[0], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_front_porch   / DVI_SYMBOLS_PER_WORD, 2, false);
 	_set_data_cb(&synclist[1], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_on,  t->h_sync_width    / DVI_SYMBOLS_PER_WORD, 2, false);
 	_set_data_cb(&synclist[2], &dma_cfg[TMDS_SYNC_LANE], sym_hsync_off, t->h_back_porch    / DVI_SYMBOLS_PER_WORD, 2, true);
@@ -296,6 +377,34 @@ void dvi_setup_scanline_for_vblank(const struct dvi_timing *t, const struct dvi_
 	}
 }
 
+void dvi_setup_scanline_for_vblank_half(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
+		bool vsync_first_half, struct dvi_scanline_dma_list *l) {
+
+	// Start from a whole line with the first half's vsync, then split the sync
+	// lane's active period at the vsync edge, h_total / 2 after hsync starts.
+	// The first part is merged into the back porch block, so the IRQ still
+	// comes from block 2, just a little later than usual.
+	dvi_setup_scanline_for_vblank(t, dma_cfg, vsync_first_half, l);
+	uint h_total = t->h_front_porch + t->h_sync_width + t->h_back_porch + t->h_active_pixels;
+	uint split = h_total / 2 - t->h_sync_width - t->h_back_porch;
+	const uint32_t *sym_second_half = get_ctrl_sym(t->v_sync_polarity != vsync_first_half, !t->h_sync_polarity);
+
+	dma_cb_t *synclist = dvi_lane_from_list(l, TMDS_SYNC_LANE);
+	synclist[2].transfer_count += split / DVI_SYMBOLS_PER_WORD;
+	_set_data_cb(&synclist[3], &dma_cfg[TMDS_SYNC_LANE], sym_second_half, (t->h_active_pixels - split) / DVI_SYMBOLS_PER_WORD, 2, false);
+}
+
+// With DVI_MONOCHROME_TMDS, the TMDS buffer holds a single lane, which is
+// sent to all three lanes.
+static inline const uint32_t *dvi_lane_tmdsbuf(const struct dvi_timing *t, const uint32_t *tmdsbuf, uint lane) {
+#if DVI_MONOCHROME_TMDS
+	(void)t; (void)lane;
+	return tmdsbuf;
+#else
+	return tmdsbuf + lane * (t->h_active_pixels / DVI_SYMBOLS_PER_WORD);
+#endif
+}
+
 void dvi_setup_scanline_for_active(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l) {
 
@@ -317,24 +426,20 @@ void dvi_setup_scanline_for_active(const struct dvi_timing *t, const struct dvi_
 		int target_block = i == TMDS_SYNC_LANE ? DVI_SYNC_LANE_CHUNKS - 1 :  DVI_NOSYNC_LANE_CHUNKS - 1;
 		if (tmdsbuf) {
 			// Non-repeating DMA for the freshly-encoded TMDS buffer
-			_set_data_cb(&cblist[target_block], &dma_cfg[i], tmdsbuf + i * (t->h_active_pixels / DVI_SYMBOLS_PER_WORD),
+			_set_data_cb(&cblist[target_block], &dma_cfg[i], dvi_lane_tmdsbuf(t, tmdsbuf, i),
 				t->h_active_pixels / DVI_SYMBOLS_PER_WORD, 0, false);
 		}
 		else {
 			// Use read ring to repeat the correct DC-balanced symbol pair on blank scanlines (4 or 8 byte period)
-			_set_data_cb(&cblist[target_block], &dma_cfg[i], &empty_scanline_tmds[2 * i / DVI_SYMBOLS_PER_WORD],
-				t->h_active_pixels / DVI_SYMBOLS_PER_WORD, DVI_SYMBOLS_PER_WORD == 2 ? 2 : 3, false);
+			_set_data_cb(&cblist[target_block], &dma_cfg[i], &empty_scanline_tmds[EMPTY_SCANLINE_WORDS_PER_LANE * i],
+				t->h_active_pixels / DVI_SYMBOLS_PER_WORD, EMPTY_SCANLINE_WORDS_PER_LANE == 1 ? 2 : 3, false);
 		}
 	}
 }
 
 void __dvi_func(dvi_update_scanline_data_dma)(const struct dvi_timing *t, const uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l) {
 	for (int i = 0; i < N_TMDS_LANES; ++i) {
-#if DVI_MONOCHROME_TMDS
-		const uint32_t *lane_tmdsbuf = tmdsbuf;
-#else
-		const uint32_t *lane_tmdsbuf = tmdsbuf + i * t->h_active_pixels / DVI_SYMBOLS_PER_WORD;
-#endif
+		const uint32_t *lane_tmdsbuf = dvi_lane_tmdsbuf(t, tmdsbuf, i);
 		if (i == TMDS_SYNC_LANE)
 			dvi_lane_from_list(l, i)[3].read_addr = lane_tmdsbuf;
 		else
@@ -5,22 +5,7 @@
 #include "pico/util/queue.h"
 
 #include "dvi.h"
-
-struct dvi_timing {
-	bool h_sync_polarity;
-	uint h_front_porch;
-	uint h_sync_width;
-	uint h_back_porch;
-	uint h_active_pixels;
-
-	bool v_sync_polarity;
-	uint v_front_porch;
-	uint v_sync_width;
-	uint v_back_porch;
-	uint v_active_lines;
-
-	uint bit_clk_khz;
-};
+#include "dvi_timing_defs.h"
 
 enum dvi_line_state {
 	DVI_STATE_FRONT_PORCH = 0,
@@ -33,6 +18,9 @@ enum dvi_line_state {
 struct dvi_timing_state {
 	uint v_ctr;
 	enum dvi_line_state v_state;
+	// For interlaced timings, 0 for the field containing the even (top) lines
+	// of the frame, 1 for the odd lines. Always 0 otherwise.
+	uint field;
 };
 
 // This should map directly to DMA register layout, but more convenient types
@@ -78,8 +66,12 @@ extern const struct dvi_timing dvi_timing_720x480p_60hz;
 extern const struct dvi_timing dvi_timing_800x480p_60hz;
 extern const struct dvi_timing dvi_timing_800x600p_60hz;
 extern const struct dvi_timing dvi_timing_960x540p_60hz;
+extern const struct dvi_timing dvi_timing_960x540p_60hz_3sym;
 extern const struct dvi_timing dvi_timing_1280x720p_30hz;
 
+extern const struct dvi_timing dvi_timing_1440x480i_60hz;
+extern const struct dvi_timing dvi_timing_1920x1080i_30hz;
+
 extern const struct dvi_timing dvi_timing_800x600p_reduced_60hz;
 extern const struct dvi_timing dvi_timing_1280x720p_reduced_30hz;
 
@@ -92,6 +84,21 @@ void dvi_scanline_dma_list_init(struct dvi_scanline_dma_list *dma_list);
 void dvi_setup_scanline_for_vblank(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		bool vsync_asserted, struct dvi_scanline_dma_list *l);
 
+// Second-field vsync line of an interlaced timing, where vsync changes state
+// half way along the line. If vsync_first_half is true, vsync is asserted for
+// the first half (the last vsync line), otherwise for the second half (the
+// first vsync line). The sync lane's active-period block is split in two, so
+// the last block is shorter than the usual h_active_pixels; see
+// dvi_sync_lane_tail_words().
+void dvi_setup_scanline_for_vblank_half(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
+		bool vsync_first_half, struct dvi_scanline_dma_list *l);
+
+// Number of words in the final block of the sync lane's list, i.e. the count
+// the sync lane data channel has left when the scanline IRQ fires.
+static inline uint dvi_sync_lane_tail_words(const struct dvi_scanline_dma_list *l) {
+	return l->l0[DVI_SYNC_LANE_CHUNKS - 1].transfer_count;
+}
+
 void dvi_setup_scanline_for_active(const struct dvi_timing *t, const struct dvi_lane_dma_cfg dma_cfg[],
 		uint32_t *tmdsbuf, struct dvi_scanline_dma_list *l);
 
@@ -0,0 +1,32 @@
+#ifndef _DVI_TIMING_DEFS_H
+#define _DVI_TIMING_DEFS_H
+
+#include "pico/types.h"
+
+// Just the timing parameters, with no hardware dependencies, so that the
+// timing generator, clock solver and EDID parser can also be built for the
+// host. See dvi_timing.h for the rest.
+
+struct dvi_timing {
+	bool h_sync_polarity;
+	uint h_front_porch;
+	uint h_sync_width;
+	uint h_back_porch;
+	uint h_active_pixels;
+
+	bool v_sync_polarity;
+	uint v_front_porch;
+	uint v_sync_width;
+	uint v_back_porch;
+	uint v_active_lines;
+
+	// If true, the v_* values above describe one field, and every other field
+	// has its vsync offset by half a line, and one extra line in total, as in
+	// CEA 1080i and 480i. Half of the horizontal total must then be a whole
+	// number of TMDS words, as that vsync edge falls half way along a line.
+	bool interlaced;
+
+	uint bit_clk_khz;
+};
+
+#endif
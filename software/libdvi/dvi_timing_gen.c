@@ -0,0 +1,259 @@
+#include "dvi_timing_gen.h"
+#include "dvi_clock.h"
+
+// Formulae are from the VESA Coordinated Video Timings standard v1.2, in
+// integer arithmetic (times in picoseconds, duty cycles in millionths of a
+// percent) so we don't drag soft float in for this. The results match the
+// `cvt` utility, e.g. dvi_timing_800x480p_60hz and
+// dvi_timing_800x600p_reduced_60hz in dvi_timing.c.
+
+#define CVT_CELL_GRAN        8
+#define CVT_MIN_V_PORCH      3
+#define CVT_MIN_V_BPORCH     6
+#define CVT_MIN_VSYNC_BP_PS  550000000ull
+#define CVT_H_SYNC_PERCENT   8
+#define CVT_C_PRIME          30
+#define CVT_M_PRIME          300
+#define CVT_CLOCK_STEP_KHZ   250
+
+#define CVT_RB_MIN_V_BLANK_PS 460000000ull
+#define CVT_RB_H_FRONT_PORCH  48
+#define CVT_RB_H_SYNC         32
+#define CVT_RB_H_BACK_PORCH   80
+#define CVT_RB_V_FPORCH       3
+
+// CVT encodes the aspect ratio in the vsync width. Same tests as the `cvt`
+// utility (xf86CVTMode()), including its divisibility checks, so that e.g.
+// 800x480 gets 10 rather than the 15:9 value.
+static uint cvt_vsync_width(uint h, uint v) {
+	if (!(v % 3) && v * 4 / 3 == h)
+		return 4;
+	else if (!(v % 9) && v * 16 / 9 == h)
+		return 5;
+	else if (!(v % 10) && v * 16 / 10 == h)
+		return 6;
+	else if (!(v % 4) && v * 5 / 4 == h)
+		return 7;
+	else if (!(v % 9) && v * 15 / 9 == h)
+		return 7;
+	else
+		return 10;
+}
+
+static bool cvt_timing(struct dvi_timing *t, uint32_t *pix_khz, uint h_active, uint v_active, uint refresh_hz) {
+	uint64_t frame_ps = 1000000000000ull / refresh_hz;
+	if (frame_ps <= CVT_MIN_VSYNC_BP_PS)
+		return false;
+	uint64_t h_period_ps = (frame_ps - CVT_MIN_VSYNC_BP_PS) / (v_active + CVT_MIN_V_PORCH);
+	uint v_sync = cvt_vsync_width(h_active, v_active);
+	uint v_sync_bp = CVT_MIN_VSYNC_BP_PS / h_period_ps + 1;
+	if (v_sync_bp < v_sync + CVT_MIN_V_BPORCH)
+		v_sync_bp = v_sync + CVT_MIN_V_BPORCH;
+
+	// Ideal blanking duty cycle is C' - M' * h_period, clamped to 20% minimum
+	int64_t duty = CVT_C_PRIME * 1000000ll - (int64_t)(CVT_M_PRIME * h_period_ps / 1000);
+	if (duty < 20 * 1000000ll)
+		duty = 20 * 1000000ll;
+	uint h_blank = (uint)((h_active * duty) / ((100 * 1000000ll - duty) * 2 * CVT_CELL_GRAN)) * 2 * CVT_CELL_GRAN;
+	uint h_total = h_active + h_blank;
+	uint h_sync = h_total * CVT_H_SYNC_PERCENT / (100 * CVT_CELL_GRAN) * CVT_CELL_GRAN;
+
+	t->h_sync_polarity = false;
+	t->h_front_porch   = h_blank / 2 - h_sync;
+	t->h_sync_width    = h_sync;
+	t->h_back_porch    = h_blank / 2;
+	t->h_active_pixels = h_active;
+
+	t->v_sync_polarity = true;
+	t->v_front_porch   = CVT_MIN_V_PORCH;
+	t->v_sync_width    = v_sync;
+	t->v_back_porch    = v_sync_bp - v_sync;
+	t->v_active_lines  = v_active;
+	t->interlaced      = false;
+
+	uint32_t khz = (uint32_t)(h_total * 1000000000ull / h_period_ps);
+	*pix_khz = khz - khz % CVT_CLOCK_STEP_KHZ;
+	return true;
+}
+
+static bool cvt_rb_timing(struct dvi_timing *t, uint32_t *pix_khz, uint h_active, uint v_active, uint refresh_hz) {
+	uint64_t frame_ps = 1000000000000ull / refresh_hz;
+	if (frame_ps <= CVT_RB_MIN_V_BLANK_PS)
+		return false;
+	uint64_t h_period_ps = (frame_ps - CVT_RB_MIN_V_BLANK_PS) / v_active;
+	uint v_sync = cvt_vsync_width(h_active, v_active);
+	uint vbi_lines = CVT_RB_MIN_V_BLANK_PS / h_period_ps + 1;
+	if (vbi_lines < CVT_RB_V_FPORCH + v_sync + CVT_MIN_V_BPORCH)
+		vbi_lines = CVT_RB_V_FPORCH + v_sync + CVT_MIN_V_BPORCH;
+	uint h_total = h_active + CVT_RB_H_FRONT_PORCH + CVT_RB_H_SYNC + CVT_RB_H_BACK_PORCH;
+
+	t->h_sync_polarity = true;
+	t->h_front_porch   = CVT_RB_H_FRONT_PORCH;
+	t->h_sync_width    = CVT_RB_H_SYNC;
+	t->h_back_porch    = CVT_RB_H_BACK_PORCH;
+	t->h_active_pixels = h_active;
+
+	t->v_sync_polarity = false;
+	t->v_front_porch   = CVT_RB_V_FPORCH;
+	t->v_sync_width    = v_sync;
+	t->v_back_porch    = vbi_lines - CVT_RB_V_FPORCH - v_sync;
+	t->v_active_lines  = v_active;
+	t->interlaced      = false;
+
+	uint32_t khz = (uint32_t)((uint64_t)refresh_hz * (v_active + vbi_lines) * h_total / 1000);
+	*pix_khz = khz - khz % CVT_CLOCK_STEP_KHZ;
+	return true;
+}
+
+// CEA-861 formats, at their integer refresh rates (e.g. 60.00 Hz rather than
+// 59.94 Hz). Some of these need an absurd clk_sys, but they're here so the
+// caller can find that out.
+struct cea_format {
+	uint8_t vic;
+	uint16_t h_active, v_active;
+	uint8_t refresh_hz;
+	bool sync_polarity;
+	uint16_t h_front_porch, h_sync_width, h_back_porch;
+	uint8_t v_front_porch, v_sync_width, v_back_porch;
+	uint32_t pix_khz;
+};
+
+static const struct cea_format cea_formats[] = {
+	// VIC   h     v   Hz  pol    h fp  sync  bp   v fp sync bp  pixel clock
+	{ 1,  640,  480, 60, false,   16,   96,  48,   10,  2, 33,  25200},
+	{ 2,  720,  480, 60, false,   16,   62,  60,    9,  6, 30,  27027},
+	{17,  720,  576, 50, false,   12,   64,  68,    5,  5, 39,  27000},
+	{ 4, 1280,  720, 60, true,   110,   40, 220,    5,  5, 20,  74250},
+	{19, 1280,  720, 50, true,   440,   40, 220,    5,  5, 20,  74250},
+	{62, 1280,  720, 30, true,  1760,   40, 220,    5,  5, 20,  74250},
+	{61, 1280,  720, 25, true,  2420,   40, 220,    5,  5, 20,  74250},
+	{60, 1280,  720, 24, true,  1760,   40, 220,    5,  5, 20,  59400},
+	{16, 1920, 1080, 60, true,    88,   44, 148,    4,  5, 36, 148500},
+	{31, 1920, 1080, 50, true,   528,   44, 148,    4,  5, 36, 148500},
+	{34, 1920, 1080, 30, true,    88,   44, 148,    4,  5, 36,  74250},
+	{33, 1920, 1080, 25, true,   528,   44, 148,    4,  5, 36,  74250},
+	{32, 1920, 1080, 24, true,   638,   44, 148,    4,  5, 36,  74250},
+};
+
+bool dvi_timing_cea_vic_mode(uint vic, uint *h_active, uint *v_active, uint *refresh_hz) {
+	// VICs 3 and 18 are the 16:9 anamorphic versions of 2 and 17, with the
+	// same timing
+	if (vic == 3 || vic == 18)
+		--vic;
+	for (uint i = 0; i < count_of(cea_formats); ++i) {
+		if (cea_formats[i].vic == vic) {
+			*h_active = cea_formats[i].h_active;
+			*v_active = cea_formats[i].v_active;
+			*refresh_hz = cea_formats[i].refresh_hz;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool cea_timing(struct dvi_timing *t, uint32_t *pix_khz, uint h_active, uint v_active, uint refresh_hz) {
+	for (uint i = 0; i < count_of(cea_formats); ++i) {
+		const struct cea_format *f = &cea_formats[i];
+		if (f->h_active != h_active || f->v_active != v_active || f->refresh_hz != refresh_hz)
+			continue;
+		t->h_sync_polarity = f->sync_polarity;
+		t->h_front_porch   = f->h_front_porch;
+		t->h_sync_width    = f->h_sync_width;
+		t->h_back_porch    = f->h_back_porch;
+		t->h_active_pixels = f->h_active;
+
+		t->v_sync_polarity = f->sync_polarity;
+		t->v_front_porch   = f->v_front_porch;
+		t->v_sync_width    = f->v_sync_width;
+		t->v_back_porch    = f->v_back_porch;
+		t->v_active_lines  = f->v_active;
+		t->interlaced      = false;
+
+		*pix_khz = f->pix_khz;
+		return true;
+	}
+	return false;
+}
+
+static uint round_to_symbols(uint x) {
+	uint r = (x + DVI_SYMBOLS_PER_WORD / 2) / DVI_SYMBOLS_PER_WORD * DVI_SYMBOLS_PER_WORD;
+	return r ? r : DVI_SYMBOLS_PER_WORD;
+}
+
+// dvi_init() panics unless every horizontal timing is a whole number of TMDS
+// words. Move the porch edges to the nearest word boundary, and round the
+// total blanking up if needed, adjusting the pixel clock so the refresh rate
+// stays put. (e.g. 960x540p60 with 3 symbols per word comes out the same as
+// dvi_timing_960x540p_60hz_3sym)
+static bool fit_to_symbols_per_word(struct dvi_timing *t, uint32_t *pix_khz) {
+	if (t->h_active_pixels % DVI_SYMBOLS_PER_WORD)
+		return false;
+	uint h_blank = t->h_front_porch + t->h_sync_width + t->h_back_porch;
+	uint h_total = h_blank + t->h_active_pixels;
+	// Interlaced timings have a vsync edge half way along the line, so need an
+	// even number of words in total
+	uint align = t->interlaced ? 2 * DVI_SYMBOLS_PER_WORD : DVI_SYMBOLS_PER_WORD;
+	uint new_blank = (h_total + align - 1) / align * align - t->h_active_pixels;
+	uint fp = round_to_symbols(t->h_front_porch);
+	uint sync = round_to_symbols(t->h_sync_width);
+	if (fp + sync + DVI_SYMBOLS_PER_WORD > new_blank)
+		return false;
+	t->h_front_porch = fp;
+	t->h_sync_width = sync;
+	t->h_back_porch = new_blank - fp - sync;
+	if (new_blank != h_blank)
+		*pix_khz = (uint32_t)((uint64_t)*pix_khz * (new_blank + t->h_active_pixels) / h_total);
+	return true;
+}
+
+bool dvi_timing_generate(struct dvi_timing *t, enum dvi_timing_method method, uint h_active, uint v_active, uint refresh_hz) {
+	if (!h_active || !v_active || !refresh_hz)
+		return false;
+	uint32_t pix_khz;
+	bool ok;
+	switch (method) {
+	case DVI_TIMING_CVT:
+		ok = cvt_timing(t, &pix_khz, h_active, v_active, refresh_hz);
+		break;
+	case DVI_TIMING_CVT_RB:
+		ok = cvt_rb_timing(t, &pix_khz, h_active, v_active, refresh_hz);
+		break;
+	case DVI_TIMING_CEA:
+		ok = cea_timing(t, &pix_khz, h_active, v_active, refresh_hz);
+		break;
+	default:
+		ok = false;
+		break;
+	}
+	return ok && dvi_timing_fit(t, pix_khz);
+}
+
+bool dvi_timing_fit(struct dvi_timing *t, uint32_t pix_khz) {
+	if (!fit_to_symbols_per_word(t, &pix_khz))
+		return false;
+	uint32_t target_khz = 10 * pix_khz;
+	t->bit_clk_khz = dvi_clock_pll_nearest_khz(target_khz, NULL);
+	uint32_t err = t->bit_clk_khz > target_khz ? t->bit_clk_khz - target_khz : target_khz - t->bit_clk_khz;
+	return (uint64_t)err * 1000000 <= (uint64_t)target_khz * DVI_CLOCK_TOLERANCE_PPM;
+}
+
+bool dvi_timing_generate_lowest_clock(struct dvi_timing *t, uint method_mask, uint h_active, uint v_active, uint refresh_hz,
+		enum dvi_timing_method *method_used) {
+	bool found = false;
+	for (uint m = 0; m < DVI_TIMING_METHOD_COUNT; ++m) {
+		struct dvi_timing candidate;
+		if (!(method_mask & (1u << m)) || !dvi_timing_generate(&candidate, m, h_active, v_active, refresh_hz))
+			continue;
+		if (!found || candidate.bit_clk_khz < t->bit_clk_khz) {
+			*t = candidate;
+			if (method_used)
+				*method_used = m;
+			found = true;
+		}
+	}
+	return found;
+}
+
+uint32_t dvi_timing_refresh_mhz(const struct dvi_timing *t) {
+	return dvi_clock_refresh_mhz(t, t->bit_clk_khz);
+}
@@ -0,0 +1,59 @@
+#ifndef _DVI_TIMING_GEN_H
+#define _DVI_TIMING_GEN_H
+
+#include "dvi_config_defs.h"
+#include "dvi_timing_defs.h"
+
+// Generate a dvi_timing at run time, rather than picking one of the constant
+// timings from dvi_timing.c. The result always satisfies libdvi's
+// constraints:
+//
+// - All horizontal timings are multiples of DVI_SYMBOLS_PER_WORD (porches
+//   are nudged to fit, keeping the same line length where possible)
+// - bit_clk_khz is a frequency the system PLL can actually generate, so with
+//   the default serialiser clk_div of 1 (clk_sys == bit clock) it can be
+//   passed straight to set_sys_clock_khz(). With a larger clk_div, clk_sys
+//   must be clk_div * bit_clk_khz instead, which dvi_clock_solve() finds.
+//
+// Snapping the bit clock to the PLL moves the refresh rate slightly; use
+// dvi_timing_refresh_mhz() to see where it ended up.
+
+enum dvi_timing_method {
+	// VESA CVT 1.2, normal blanking. What `cvt` prints.
+	DVI_TIMING_CVT,
+	// CVT reduced blanking (v1), what `cvt -r` prints. Much shorter blanking,
+	// so a much lower clock, but not every display accepts it.
+	DVI_TIMING_CVT_RB,
+	// CEA-861 formats. These only exist for a fixed set of resolutions and
+	// refresh rates, and are the ones TVs are guaranteed to accept.
+	DVI_TIMING_CEA,
+	DVI_TIMING_METHOD_COUNT
+};
+
+#define DVI_TIMING_METHODS_ALL ((1u << DVI_TIMING_METHOD_COUNT) - 1)
+
+// Returns false if the method has no timing for this mode (e.g. not a CEA
+// format, or h_active not a multiple of DVI_SYMBOLS_PER_WORD) or if the PLL
+// can't get within DVI_CLOCK_TOLERANCE_PPM of the bit clock.
+bool dvi_timing_generate(struct dvi_timing *t, enum dvi_timing_method method, uint h_active, uint v_active, uint refresh_hz);
+
+// Try each method in turn and keep the one with the lowest clk_sys. Methods
+// the display doesn't accept can be masked out with method_mask (bit n set
+// means method n may be used). The chosen method is written to *method_used,
+// which may be NULL.
+bool dvi_timing_generate_lowest_clock(struct dvi_timing *t, uint method_mask, uint h_active, uint v_active, uint refresh_hz,
+	enum dvi_timing_method *method_used);
+
+// Apply the same constraints to a timing from elsewhere, e.g. a detailed
+// timing from a display's EDID, with its nominal pixel clock in kHz. Fills in
+// bit_clk_khz. Returns false if it can't be made to fit.
+bool dvi_timing_fit(struct dvi_timing *t, uint32_t pix_khz);
+
+// Look up a CEA-861 Video Identification Code (VIC). Returns false if it's
+// not one of the formats DVI_TIMING_CEA can generate.
+bool dvi_timing_cea_vic_mode(uint vic, uint *h_active, uint *v_active, uint *refresh_hz);
+
+// Frame rate in millihertz, given the timing's bit clock
+uint32_t dvi_timing_refresh_mhz(const struct dvi_timing *t);
+
+#endif
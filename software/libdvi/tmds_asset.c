@@ -0,0 +1,60 @@
+#include "hardware/dma.h"
+#include "hardware/regs/addressmap.h"
+#include "tmds_asset.h"
+
+// Returns a pointer to the first run of the next lane
+static const uint8_t *__not_in_flash_func(tmds_asset_expand_rle)(const uint8_t *src, const uint32_t *pairs, uint32_t *dst, uint n_words) {
+	uint32_t *dst_end = dst + n_words;
+	while (dst < dst_end) {
+		uint32_t pair = pairs[src[0]];
+		uint count = src[1] + 1;
+		src += 2;
+		while (count--)
+			*dst++ = pair;
+	}
+	return src;
+}
+
+void __not_in_flash_func(tmds_asset_render_line)(const struct tmds_asset *asset, uint y, uint32_t *tmdsbuf, uint dma_chan) {
+	const uint words_per_lane = asset->width / 2;
+	const void *line = tmds_asset_line_data(asset, y);
+	if (asset->flags & TMDS_ASSET_RLE) {
+		const uint8_t *src = line;
+		const uint32_t *pairs = (const uint32_t*)((uintptr_t)asset + asset->pairs_offset);
+		for (uint lane = 0; lane < asset->n_lanes; ++lane)
+			src = tmds_asset_expand_rle(src, pairs, tmdsbuf + lane * words_per_lane, words_per_lane);
+	}
+	else {
+		dma_channel_config c = dma_channel_get_default_config(dma_chan);
+		channel_config_set_read_increment(&c, true);
+		channel_config_set_write_increment(&c, true);
+		channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+		dma_channel_configure(dma_chan, &c, tmdsbuf, line, asset->n_lanes * words_per_lane, true);
+		dma_channel_wait_for_finish_blocking(dma_chan);
+	}
+}
+
+void __not_in_flash_func(dvi_tmds_asset_main)(struct dvi_inst *inst, const struct tmds_asset *asset) {
+	const uint n_lines = inst->timing->v_active_lines / DVI_VERTICAL_REPEAT;
+	assert(asset->magic == TMDS_ASSET_MAGIC);
+	assert(asset->width == inst->timing->h_active_pixels);
+	assert(asset->height >= n_lines);
+	assert(asset->n_lanes == (DVI_MONOCHROME_TMDS ? 1 : N_TMDS_LANES));
+	assert(DVI_SYMBOLS_PER_WORD == 2);
+
+	bool zero_copy = !(asset->flags & TMDS_ASSET_RLE) && (uintptr_t)asset >= SRAM_BASE;
+	uint dma_chan = zero_copy ? 0 : dma_claim_unused_channel(true);
+	uint y = 0;
+	while (1) {
+		uint32_t *tmdsbuf;
+		queue_remove_blocking_u32(&inst->q_tmds_free, &tmdsbuf);
+		if (zero_copy)
+			tmdsbuf = (uint32_t*)tmds_asset_line_data(asset, y);
+		else
+			tmds_asset_render_line(asset, y, tmdsbuf, dma_chan);
+		queue_add_blocking_u32(&inst->q_tmds_valid, &tmdsbuf);
+		if (++y == n_lines)
+			y = 0;
+	}
+	__builtin_unreachable();
+}
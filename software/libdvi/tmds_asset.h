@@ -0,0 +1,72 @@
+#ifndef _TMDS_ASSET_H
+#define _TMDS_ASSET_H
+
+#include "pico/types.h"
+#include "dvi.h"
+
+// Pre-encoded TMDS images, as produced by scripts/tmdsasset. These are
+// already TMDS symbols, so displaying them costs no encode cycles: raw lines
+// in SRAM are passed straight to the DVI DMA, and other lines are copied or
+// expanded into a TMDS buffer.
+//
+// All offsets are in bytes from the start of the asset, and all fields are
+// little-endian. The asset is:
+//
+// - This header
+// - Line table: height words, each the offset of that line's data. Identical
+//   lines are only stored once.
+// - Pair table (RLE only): n_pairs words, each a DC-balanced symbol pair
+// - Line data
+//
+// Raw line data is n_lanes * width / 2 words of symbol pairs, lane 0 (blue)
+// first, in the same layout as a TMDS buffer from dvi.c. Each lane is a full
+// TMDS encode of that line, so any 8-bit colour is exact.
+//
+// RLE line data is a list of byte pairs (pair index, run length - 1) for
+// lane 0, then the same for lane 1, and so on. Each lane ends once it has
+// produced width / 2 symbol pairs, so no lane length is stored. Every entry
+// in the pair table is DC-balanced, which is what makes it legal to put them
+// in any order.
+//
+// n_lanes is 3 for colour, or 1 for use with DVI_MONOCHROME_TMDS.
+
+#define TMDS_ASSET_MAGIC 0x41444d54u // "TMDA"
+
+#define TMDS_ASSET_RLE 0x1u
+
+struct tmds_asset {
+	uint32_t magic;
+	uint16_t width;
+	uint16_t height;
+	uint8_t n_lanes;
+	uint8_t flags;
+	uint16_t n_pairs;
+	uint32_t lines_offset;
+	uint32_t pairs_offset;
+};
+
+static inline const void *tmds_asset_line_data(const struct tmds_asset *asset, uint y) {
+	const uint32_t *line_table = (const uint32_t*)((uintptr_t)asset + asset->lines_offset);
+	return (const void*)((uintptr_t)asset + line_table[y]);
+}
+
+// Write line y of the asset into tmdsbuf (n_lanes * width / 2 words).
+// Raw lines are copied using DMA channel dma_chan, which must be claimed by
+// the caller. RLE lines are expanded on this core.
+void tmds_asset_render_line(const struct tmds_asset *asset, uint y, uint32_t *tmdsbuf, uint dma_chan);
+
+// TMDS encode worker function: core enters and doesn't leave, but still
+// responds to IRQs. Passes the asset's lines to the tmds valid queue, one
+// frame after another. asset->width must be the display width, and
+// asset->height must be at least the number of displayed lines.
+//
+// If the asset is raw and in SRAM, line pointers are passed straight to DVI.
+// The buffers popped from the free queue are then not used, because the DVI
+// IRQ will hand back our line pointers in their place, so don't return to
+// normal rendering afterward.
+//
+// Note flash is too slow to copy full-width raw lines at most resolutions, so
+// use RLE for assets which stay in flash.
+void dvi_tmds_asset_main(struct dvi_inst *inst, const struct tmds_asset *asset);
+
+#endif
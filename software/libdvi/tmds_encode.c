@@ -2,6 +2,7 @@
 #include "tmds_encode.h"
 #include "hardware/gpio.h"
 #include "hardware/sync.h"
+#include "interp_owner.h"
 
 static const __unused uint32_t __scratch_x("tmds_table") tmds_table[] = {
 #include "tmds_table.h"
@@ -19,7 +20,9 @@ const __unused uint32_t __scratch_y("tmds_table_fullres_y") tmds_table_fullres_y
 #include "tmds_table_fullres.h"
 };
 
-#if !DVI_USE_SIO_TMDS_ENCODER
+#if DVI_SYMBOLS_PER_WORD == 3
+// Neither the interpolators nor the SIO TMDS encoder are used, see below
+#elif !DVI_USE_SIO_TMDS_ENCODER
 // Configure an interpolator to extract a single colour channel from each of a pair
 // of pixels, with the first pixel's lsb at pixel_lsb, and the pixels being
 // pixel_width wide. Produce a LUT address for the first pixel's colour data on
@@ -29,6 +32,10 @@ const __unused uint32_t __scratch_y("tmds_table_fullres_y") tmds_table_fullres_y
 // (needed for blue channel because I was a stubborn idiot and didn't put
 // signed/bidirectional shift on interpolator, very slightly slower). The
 // return value is the size of left shift required.
+//
+// The interpolator setup is skipped if it's already configured the same way
+// on this core (see interp_owner.h). lutbase is always tmds_table, so it is
+// not part of the key.
 
 static int __not_in_flash_func(configure_interp_for_addrgen)(interp_hw_t *interp, uint channel_msb, uint channel_lsb, uint pixel_lsb, uint pixel_width, uint lut_index_width, const uint32_t *lutbase) {
 	interp_config c;
@@ -48,15 +55,21 @@ static int __not_in_flash_func(configure_interp_for_addrgen)(interp_hw_t *interp
 #endif
 
 	uint index_msb = index_shift + lut_index_width - 1;
+	// Channel LSBs which don't fit in the table index are dropped
+	uint index_lsb = index_msb - MIN(channel_msb - channel_lsb, lut_index_width - 1);
+
+	if (interp_owner_claim(interp, INTERP_OWNER_KEY(INTERP_OWNER_TMDS_ADDRGEN,
+			shift_channel_to_index | index_lsb << 5 | index_msb << 10 | pixel_width << 15)))
+		return oops;
 
 	c = interp_default_config();
 	interp_config_set_shift(&c, shift_channel_to_index);
-	interp_config_set_mask(&c, index_msb - (channel_msb - channel_lsb), index_msb);
+	interp_config_set_mask(&c, index_lsb, index_msb);
 	interp_set_config(interp, 0, &c);
 
 	c = interp_default_config();
 	interp_config_set_shift(&c, pixel_width	+ shift_channel_to_index);
-	interp_config_set_mask(&c, index_msb - (channel_msb - channel_lsb), index_msb);
+	interp_config_set_mask(&c, index_lsb, index_msb);
 	interp_config_set_cross_input(&c, true);
 	interp_set_config(interp, 1, &c);
 
@@ -81,12 +94,47 @@ static void __not_in_flash_func(configure_sio_tmds_for_single_channel)(uint chan
 }
 #endif
 
-// Extract up to 6 bits from a buffer of 16 bit pixels, and produce a buffer
+#if DVI_SYMBOLS_PER_WORD == 3
+// With 3 symbols per word, every other doubled pixel straddles two words.
+// Neither the interpolator loops nor the SIO loops can produce that, so the
+// doubled encoders use a plain table lookup instead. Pairs are as found in
+// tmds_table (sym | sym << 10), and three of them fill two words.
+static inline void put_pairs_3sym(uint32_t *symbuf, uint32_t p0, uint32_t p1, uint32_t p2) {
+	symbuf[0] = p0 | (p1 & 0x3ffu) << 20;
+	symbuf[1] = p1 >> 10 | p2 << 10;
+}
+
+// Number of pixels must be a multiple of 3. The table index is the top
+// TMDS_TABLE_BITS bits of the channel, same as the interpolator loops.
+static void __not_in_flash_func(tmds_encode_doubled_3sym)(const void *pixbuf, uint32_t *symbuf, size_t n_pix, uint pixel_width, uint channel_msb, uint channel_lsb) {
+	assert(n_pix % 3 == 0);
+	const uint idx_bits = MIN(channel_msb - channel_lsb + 1, TMDS_TABLE_BITS);
+	const uint32_t idx_mask = ((1u << idx_bits) - 1) << (TMDS_TABLE_BITS - idx_bits);
+	const uint lshift = 31 - channel_msb;
+#define ENCODE_3SYM(pix) tmds_table[((uint32_t)(pix) << lshift >> (32 - TMDS_TABLE_BITS)) & idx_mask]
+	if (pixel_width == 16) {
+		const uint16_t *pix = pixbuf, *end = pix + n_pix;
+		for (; pix < end; pix += 3, symbuf += 2)
+			put_pairs_3sym(symbuf, ENCODE_3SYM(pix[0]), ENCODE_3SYM(pix[1]), ENCODE_3SYM(pix[2]));
+	}
+	else {
+		const uint8_t *pix = pixbuf, *end = pix + n_pix;
+		for (; pix < end; pix += 3, symbuf += 2)
+			put_pairs_3sym(symbuf, ENCODE_3SYM(pix[0]), ENCODE_3SYM(pix[1]), ENCODE_3SYM(pix[2]));
+	}
+#undef ENCODE_3SYM
+}
+#endif
+
+// Extract up to TMDS_TABLE_BITS bits from a buffer of 16 bit pixels, and produce a buffer
 // of TMDS symbols from this colour channel. Number of pixels must be even,
-// pixel buffer must be word-aligned.
+// pixel buffer must be word-aligned. (Multiple of 3 pixels for
+// DVI_SYMBOLS_PER_WORD == 3.)
 
 void __not_in_flash_func(tmds_encode_data_channel_16bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
-#if DVI_USE_SIO_TMDS_ENCODER
+#if DVI_SYMBOLS_PER_WORD == 3
+	tmds_encode_doubled_3sym(pixbuf, symbuf, n_pix, 16, channel_msb, channel_lsb);
+#elif DVI_USE_SIO_TMDS_ENCODER
 	configure_sio_tmds_for_single_channel(channel_msb, channel_lsb, 16, true);
 #if DVI_SYMBOLS_PER_WORD == 1
 	tmds_encode_sio_loop_peekpop_ratio4(pixbuf, symbuf, 2 * n_pix);
@@ -94,9 +142,7 @@ void __not_in_flash_func(tmds_encode_data_channel_16bpp)(const uint32_t *pixbuf,
 	tmds_encode_sio_loop_poppop_ratio2(pixbuf, symbuf, 2 * n_pix);
 #endif
 #else
-	interp_hw_save_t interp0_save;
-	interp_save(interp0_hw, &interp0_save);
-	int require_lshift = configure_interp_for_addrgen(interp0_hw, channel_msb, channel_lsb, 0, 16, 6, tmds_table);
+	int require_lshift = configure_interp_for_addrgen(interp0_hw, channel_msb, channel_lsb, 0, 16, TMDS_TABLE_BITS, tmds_table);
 #if PICO_RP2040
 	if (require_lshift)
 		tmds_encode_loop_16bpp_leftshift(pixbuf, symbuf, n_pix, require_lshift);
@@ -106,13 +152,14 @@ void __not_in_flash_func(tmds_encode_data_channel_16bpp)(const uint32_t *pixbuf,
 	assert(!require_lshift); (void)require_lshift;
 	tmds_encode_loop_16bpp(pixbuf, symbuf, n_pix);
 #endif
-	interp_restore(interp0_hw, &interp0_save);
 #endif
 }
 
 // As above, but 8 bits per pixel, multiple of 4 pixels, and still word-aligned.
 void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
-#if DVI_USE_SIO_TMDS_ENCODER
+#if DVI_SYMBOLS_PER_WORD == 3
+	tmds_encode_doubled_3sym(pixbuf, symbuf, n_pix, 8, channel_msb, channel_lsb);
+#elif DVI_USE_SIO_TMDS_ENCODER
 	configure_sio_tmds_for_single_channel(channel_msb, channel_lsb, 8, true);
 #if DVI_SYMBOLS_PER_WORD == 1
 	tmds_encode_sio_loop_peekpop_ratio8(pixbuf, symbuf, 2 * n_pix);
@@ -120,14 +167,11 @@ void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf,
 	tmds_encode_sio_loop_poppop_ratio4(pixbuf, symbuf, 2 * n_pix);
 #endif
 #else
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
 	// Note that for 8bpp, some left shift is always required for pixel 0 (any
 	// channel), which destroys some MSBs of pixel 3. To get around this, pixel
 	// data sent to interp1 is *not left-shifted*
-	int require_lshift = configure_interp_for_addrgen(interp0_hw, channel_msb, channel_lsb, 0, 8, 6, tmds_table);
-	int lshift_upper = configure_interp_for_addrgen(interp1_hw, channel_msb, channel_lsb, 16, 8, 6, tmds_table);
+	int require_lshift = configure_interp_for_addrgen(interp0_hw, channel_msb, channel_lsb, 0, 8, TMDS_TABLE_BITS, tmds_table);
+	int lshift_upper = configure_interp_for_addrgen(interp1_hw, channel_msb, channel_lsb, 16, 8, TMDS_TABLE_BITS, tmds_table);
 	assert(!lshift_upper); (void)lshift_upper;
 #if PICO_RP2040
 	if (require_lshift)	
@@ -138,11 +182,90 @@ void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf,
 	assert(!require_lshift); (void)require_lshift;
 	tmds_encode_loop_8bpp(pixbuf, symbuf, n_pix);
 #endif
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
 #endif
 }
 
+// 4x4 Bayer matrix, scaled to 16 bits with a half-step offset so that
+// thresholds are centred in each step.
+static const uint16_t __not_in_flash("tmds_dither") dither_thresholds[4][4] = {
+	{ 0 << 12 | 0x800,  8 << 12 | 0x800,  2 << 12 | 0x800, 10 << 12 | 0x800},
+	{12 << 12 | 0x800,  4 << 12 | 0x800, 14 << 12 | 0x800,  6 << 12 | 0x800},
+	{ 3 << 12 | 0x800, 11 << 12 | 0x800,  1 << 12 | 0x800,  9 << 12 | 0x800},
+	{15 << 12 | 0x800,  7 << 12 | 0x800, 13 << 12 | 0x800,  5 << 12 | 0x800},
+};
+
+// Extract one 8 bit channel from a buffer of 24 bit pixels (one per word,
+// same layout as tmds_setup_palette24_pairs(), so the channel lsb is 0, 8 or
+// 16), apply a 4x4 ordered dither while quantising to out_bits bits, and
+// produce a buffer of pixel-doubled TMDS symbols. This is the same output
+// you'd get by converting to RGB565 (out_bits 5/6/5) or RGB332 (3/3/2) and
+// then calling tmds_encode_data_channel_16bpp/8bpp, but in one pass, and
+// without the banding. y is the scanline number, for the dither pattern;
+// the first pixel in the buffer is x = 0. Number of pixels must be a
+// multiple of 4 (multiple of 3 for DVI_SYMBOLS_PER_WORD == 3).
+//
+// The quantised value is (c * (2^n - 1) + threshold) / 255, so 0 and 255 are
+// always exact and no saturation is needed. This doesn't use the
+// interpolators.
+void __not_in_flash_func(tmds_encode_data_channel_rgb888_dither)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_lsb, uint out_bits, uint y) {
+	assert(out_bits >= 1 && out_bits <= 8);
+	assert(n_pix % (DVI_SYMBOLS_PER_WORD == 3 ? 3 : 4) == 0);
+	// Quantise straight to the table width if the table is narrower
+	if (out_bits > TMDS_TABLE_BITS)
+		out_bits = TMDS_TABLE_BITS;
+	// 257 / 65536 is close enough to 1 / 255 for 8 bit inputs
+	const uint32_t scale = ((1u << out_bits) - 1) * 257;
+	const uint idx_shift = TMDS_TABLE_BITS - out_bits;
+	const uint16_t *t = dither_thresholds[y & 3];
+	uint32_t t0 = t[0], t1 = t[1], t2 = t[2], t3 = t[3];
+	const uint32_t *end = pixbuf + n_pix;
+#define DITHER_ENCODE(pix, thresh) \
+	tmds_table[((((pix) >> channel_lsb & 0xffu) * scale + (thresh)) >> 16) << idx_shift]
+#if DVI_SYMBOLS_PER_WORD == 3
+	while (pixbuf < end) {
+		put_pairs_3sym(symbuf,
+			DITHER_ENCODE(pixbuf[0], t0),
+			DITHER_ENCODE(pixbuf[1], t1),
+			DITHER_ENCODE(pixbuf[2], t2)
+		);
+		pixbuf += 3;
+		symbuf += 2;
+		// Next pixel is at x + 3, so rotate the thresholds by 3 (i.e. back by 1)
+		uint32_t tmp = t3;
+		t3 = t2;
+		t2 = t1;
+		t1 = t0;
+		t0 = tmp;
+	}
+#else
+	while (pixbuf < end) {
+		uint32_t s0 = DITHER_ENCODE(pixbuf[0], t0);
+		uint32_t s1 = DITHER_ENCODE(pixbuf[1], t1);
+		uint32_t s2 = DITHER_ENCODE(pixbuf[2], t2);
+		uint32_t s3 = DITHER_ENCODE(pixbuf[3], t3);
+		pixbuf += 4;
+#if DVI_SYMBOLS_PER_WORD == 1
+		symbuf[0] = s0 & 0x3ff;
+		symbuf[1] = s0 >> 10;
+		symbuf[2] = s1 & 0x3ff;
+		symbuf[3] = s1 >> 10;
+		symbuf[4] = s2 & 0x3ff;
+		symbuf[5] = s2 >> 10;
+		symbuf[6] = s3 & 0x3ff;
+		symbuf[7] = s3 >> 10;
+		symbuf += 8;
+#else
+		symbuf[0] = s0;
+		symbuf[1] = s1;
+		symbuf[2] = s2;
+		symbuf[3] = s3;
+		symbuf += 4;
+#endif
+	}
+#endif
+#undef DITHER_ENCODE
+}
+
 // ----------------------------------------------------------------------------
 // Code for full-resolution TMDS encode (barely possible, utterly impractical):
 
@@ -152,7 +275,7 @@ void __not_in_flash_func(tmds_encode_data_channel_8bpp)(const uint32_t *pixbuf,
 // pixels, and INTERP1 for odd pixels. Note this means that even and odd
 // symbols have their DC balance handled separately, which is not to spec.
 
-#if !DVI_USE_SIO_TMDS_ENCODER
+#if !DVI_USE_SIO_TMDS_ENCODER && DVI_SYMBOLS_PER_WORD != 3
 static int __not_in_flash_func(configure_interp_for_addrgen_fullres)(interp_hw_t *interp, uint channel_msb, uint channel_lsb, uint lut_index_width, const uint32_t *lutbase) {
 	const uint index_shift = 2; // scaled lookup for 4-byte LUT entries
 
@@ -170,12 +293,18 @@ static int __not_in_flash_func(configure_interp_for_addrgen_fullres)(interp_hw_t
 #endif
 
 	uint index_msb = index_shift + lut_index_width - 1;
+	uint index_lsb = index_msb - MIN(channel_msb - channel_lsb, lut_index_width - 1);
+
+	// lutbase is fixed for each core, so not part of the key
+	if (interp_owner_claim(interp, INTERP_OWNER_KEY(INTERP_OWNER_TMDS_FULLRES,
+			shift_channel_to_index | index_lsb << 5 | index_msb << 10)))
+		return oops;
 
 	interp_config c;
-	// Shift and mask colour channel to lower 6 bits of LUT index (note lut_index_width excludes disparity sign)
+	// Shift and mask colour channel to lower bits of LUT index (note lut_index_width excludes disparity sign)
 	c = interp_default_config();
 	interp_config_set_shift(&c, shift_channel_to_index);
-	interp_config_set_mask(&c, index_msb - (channel_msb - channel_lsb), index_msb);
+	interp_config_set_mask(&c, index_lsb, index_msb);
 	interp_set_config(interp, 0, &c);
 
 	// Concatenate disparity (ACCUM1) sign onto the LUT index
@@ -191,7 +320,11 @@ static int __not_in_flash_func(configure_interp_for_addrgen_fullres)(interp_hw_t
 #endif
 
 void __not_in_flash_func(tmds_encode_data_channel_fullres_16bpp)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb) {
-#if DVI_USE_SIO_TMDS_ENCODER
+#if DVI_SYMBOLS_PER_WORD == 3
+	// No full-resolution encode for 3 symbols per word
+	(void)pixbuf; (void)symbuf; (void)n_pix; (void)channel_msb; (void)channel_lsb;
+	panic_unsupported();
+#elif DVI_USE_SIO_TMDS_ENCODER
 	configure_sio_tmds_for_single_channel(channel_msb, channel_lsb, 16, false);
 #if DVI_SYMBOLS_PER_WORD == 1
 	tmds_encode_sio_loop_poppop_ratio2(pixbuf, symbuf, n_pix);
@@ -200,18 +333,13 @@ void __not_in_flash_func(tmds_encode_data_channel_fullres_16bpp)(const uint32_t
 #endif
 #else
 	uint core = get_core_num();
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
-#endif
 
 	// There is a copy of the inner loop and the LUT in both scratch X and
 	// scratch Y memories. Use X on core 1 and Y on core 0 so the cores don't
 	// tread on each other's toes too much.
 	const uint32_t *lutbase = core ? tmds_table_fullres_x : tmds_table_fullres_y;
-	int lshift_lower = configure_interp_for_addrgen_fullres(interp0_hw, channel_msb, channel_lsb, 6, lutbase);
-	int lshift_upper = configure_interp_for_addrgen_fullres(interp1_hw, channel_msb + 16, channel_lsb + 16, 6, lutbase);
+	int lshift_lower = configure_interp_for_addrgen_fullres(interp0_hw, channel_msb, channel_lsb, TMDS_FULLRES_TABLE_BITS, lutbase);
+	int lshift_upper = configure_interp_for_addrgen_fullres(interp1_hw, channel_msb + 16, channel_lsb + 16, TMDS_FULLRES_TABLE_BITS, lutbase);
 	assert(!lshift_upper); (void)lshift_upper;
 	if (lshift_lower) {
 		(core ?
@@ -225,35 +353,22 @@ void __not_in_flash_func(tmds_encode_data_channel_fullres_16bpp)(const uint32_t
 			tmds_fullres_encode_loop_16bpp_y
 		)(pixbuf, symbuf, n_pix);
 	}
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
-#endif
 #endif
 }
 
-static const int8_t imbalance_lookup[16] = { -4, -2, -2, 0, -2, 0, 0, 2, -2, 0, 0, 2, 0, 2, 2, 4 };
+static const int8_t __not_in_flash("tmds_table_qm") imbalance_lookup[16] = { -4, -2, -2, 0, -2, 0, 0, 2, -2, 0, 0, 2, 0, 2, 2, 4 };
 
-static inline int byte_imbalance(uint32_t x) {
-	return imbalance_lookup[x >> 4] + imbalance_lookup[x & 0xF];
-}
+// Transition-minimised symbol and its imbalance for each data byte, so the
+// palette code doesn't have to run the encoder bit by bit. In RAM so palette
+// updates can be done per-line without touching flash.
+static const uint16_t __not_in_flash("tmds_table_qm") tmds_table_qm[] = {
+#include "tmds_table_qm.h"
+};
 
-static void tmds_encode_symbols(uint8_t pixel, uint32_t* negative_balance_sym, uint32_t* positive_balance_sym) {
-	int pixel_imbalance = byte_imbalance(pixel);
-	uint32_t sym = pixel & 1;
-	if (pixel_imbalance > 0 || (pixel_imbalance == 0 && sym == 0)) {
-		for (int i = 0; i < 7; ++i) {
-			sym |= (~((sym >> i) ^ (pixel >> (i + 1))) & 1) << (i + 1);
-		}
-	}
-	else {
-		for (int i = 0; i < 7; ++i) {
-			sym |= ( ((sym >> i) ^ (pixel >> (i + 1))) & 1) << (i + 1);
-		}
-		sym |= 0x100;
-	}
+static inline void tmds_encode_symbols(uint8_t pixel, uint32_t* negative_balance_sym, uint32_t* positive_balance_sym) {
+	uint32_t sym = tmds_table_qm[pixel] & 0x1ff;
+	int imbalance = (int16_t)tmds_table_qm[pixel] >> 10;
 
-	int imbalance = byte_imbalance(sym & 0xFF);
 	if (imbalance == 0) {
 		if ((sym & 0x100) == 0) sym ^= 0x2ff;
 		*positive_balance_sym = sym;
@@ -275,10 +390,26 @@ static void tmds_encode_symbols(uint8_t pixel, uint32_t* negative_balance_sym, u
 // The TMDS palette buffer should be 6 * n_palette words long.
 // n_palette must be a power of 2 <= 256.
 void tmds_setup_palette_symbols(const uint16_t *palette, uint32_t *tmds_palette, size_t n_palette) {
+	tmds_update_palette_symbols(palette, tmds_palette, n_palette, 0, n_palette);
+}
+
+// This takes a 24-bit (RGB 888) colour palette and makes palettes of TMDS symbols suitable
+// for performing fullres encode.
+// The TMDS palette buffer should be 6 * n_palette words long.
+// n_palette must be a power of 2 <= 256.
+void tmds_setup_palette24_symbols(const uint32_t *palette, uint32_t *tmds_palette, size_t n_palette) {
+	tmds_update_palette24_symbols(palette, tmds_palette, n_palette, 0, n_palette);
+}
+
+// Re-encode only palette entries first to first + count - 1, e.g. after
+// changing a few colours between frames or scanlines. palette is the whole
+// colour palette, and tmds_palette was set up by tmds_setup_palette_symbols.
+void __not_in_flash_func(tmds_update_palette_symbols)(const uint16_t *palette, uint32_t *tmds_palette, size_t n_palette, uint first, uint count) {
+	assert(first + count <= n_palette);
 	uint32_t* tmds_palette_blue = tmds_palette;
 	uint32_t* tmds_palette_green = tmds_palette + 2 * n_palette;
 	uint32_t* tmds_palette_red = tmds_palette + 4 * n_palette;
-	for (int i = 0; i < n_palette; ++i) {
+	for (uint i = first; i < first + count; ++i) {
 		uint16_t blue = (palette[i] << 3) & 0xf8;
 		uint16_t green = (palette[i] >> 3) & 0xfc;
 		uint16_t red = (palette[i] >> 8) & 0xf8;
@@ -288,15 +419,12 @@ void tmds_setup_palette_symbols(const uint16_t *palette, uint32_t *tmds_palette,
 	}
 }
 
-// This takes a 24-bit (RGB 888) colour palette and makes palettes of TMDS symbols suitable
-// for performing fullres encode.
-// The TMDS palette buffer should be 6 * n_palette words long.
-// n_palette must be a power of 2 <= 256.
-void tmds_setup_palette24_symbols(const uint32_t *palette, uint32_t *tmds_palette, size_t n_palette) {
+void __not_in_flash_func(tmds_update_palette24_symbols)(const uint32_t *palette, uint32_t *tmds_palette, size_t n_palette, uint first, uint count) {
+	assert(first + count <= n_palette);
 	uint32_t* tmds_palette_blue = tmds_palette;
 	uint32_t* tmds_palette_green = tmds_palette + 2 * n_palette;
 	uint32_t* tmds_palette_red = tmds_palette + 4 * n_palette;
-	for (int i = 0; i < n_palette; ++i) {
+	for (uint i = first; i < first + count; ++i) {
 		uint16_t blue = palette[i] & 0xff;
 		uint16_t green = (palette[i] >> 8) & 0xff;
 		uint16_t red = (palette[i] >> 16) & 0xff;
@@ -306,63 +434,404 @@ void tmds_setup_palette24_symbols(const uint32_t *palette, uint32_t *tmds_palett
 	}
 }
 
+static inline void reverse_words(uint32_t *start, uint32_t *end) {
+	while (start < --end) {
+		uint32_t tmp = *start;
+		*start++ = *end;
+		*end = tmp;
+	}
+}
+
+// Rotate each of the n_tables sub-tables of a TMDS palette, so that entry
+// first + i moves to first + (i + steps) % count. No re-encoding is needed, so
+// this is cheap enough for colour cycling every frame.
+static void __not_in_flash_func(rotate_palette_tables)(uint32_t *tmds_palette, size_t n_palette, uint n_tables, uint first, uint count, int steps) {
+	assert(first + count <= n_palette);
+	if (!count)
+		return;
+	steps %= (int)count;
+	if (steps < 0)
+		steps += count;
+	if (!steps)
+		return;
+	for (uint t = 0; t < n_tables; ++t) {
+		uint32_t *base = tmds_palette + t * n_palette + first;
+		reverse_words(base, base + count);
+		reverse_words(base, base + steps);
+		reverse_words(base + steps, base + count);
+	}
+}
+
+void __not_in_flash_func(tmds_rotate_palette_symbols)(uint32_t *tmds_palette, size_t n_palette, uint first, uint count, int steps) {
+	rotate_palette_tables(tmds_palette, n_palette, 6, first, count, steps);
+}
+
+// Direct translation of the DVI 1.0 TMDS encode algorithm, same as the
+// TMDSEncode class in tmds_table_gen.py. Returns a 10-bit symbol and updates
+// the running imbalance.
+static uint32_t tmds_encode_dvi(uint8_t d, int *imbalance) {
+	uint32_t q_m = tmds_table_qm[d] & 0x1ff;
+	int q_imbalance = (int16_t)tmds_table_qm[d] >> 10;
+	if (*imbalance == 0 || q_imbalance == 0) {
+		if (q_m & 0x100) {
+			*imbalance += q_imbalance;
+			return q_m;
+		}
+		*imbalance -= q_imbalance;
+		return q_m ^ 0x2ff;
+	}
+	else if ((*imbalance > 0) == (q_imbalance > 0)) {
+		*imbalance += (int)((q_m & 0x100) >> 7) - q_imbalance;
+		return q_m ^ 0x2ff;
+	}
+	else {
+		*imbalance += q_imbalance - (int)((~q_m & 0x100) >> 7);
+		return q_m;
+	}
+}
+
+// Encoding x & ~1 followed by x | 1 from a running imbalance of 0 always
+// gives a net imbalance of 0, so the pair can be used at any position in the
+// scanline without tracking disparity. Costs up to 1 LSB of colour accuracy.
+static uint32_t tmds_encode_balanced_pair(uint8_t x) {
+	int imbalance = 0;
+	uint32_t sym0 = tmds_encode_dvi(x & ~1u, &imbalance);
+	uint32_t sym1 = tmds_encode_dvi(x | 1u, &imbalance);
+	return sym0 | (sym1 << 10);
+}
+
+// This takes a 16-bit (RGB 565) colour palette and makes a table of balanced
+// TMDS symbol pairs suitable for pixel-doubled palette encode.
+// The TMDS palette buffer should be 3 * n_palette words long.
+// n_palette must be a power of 2 <= 256.
+void tmds_setup_palette_pairs(const uint16_t *palette, uint32_t *tmds_palette, size_t n_palette) {
+	tmds_update_palette_pairs(palette, tmds_palette, n_palette, 0, n_palette);
+}
+
+// As above, but from a 24-bit (RGB 888) colour palette.
+void tmds_setup_palette24_pairs(const uint32_t *palette, uint32_t *tmds_palette, size_t n_palette) {
+	tmds_update_palette24_pairs(palette, tmds_palette, n_palette, 0, n_palette);
+}
+
+void __not_in_flash_func(tmds_update_palette_pairs)(const uint16_t *palette, uint32_t *tmds_palette, size_t n_palette, uint first, uint count) {
+	assert(first + count <= n_palette);
+	for (uint i = first; i < first + count; ++i) {
+		tmds_palette[i] = tmds_encode_balanced_pair((palette[i] << 3) & 0xf8);
+		tmds_palette[i + n_palette] = tmds_encode_balanced_pair((palette[i] >> 3) & 0xfc);
+		tmds_palette[i + 2 * n_palette] = tmds_encode_balanced_pair((palette[i] >> 8) & 0xf8);
+	}
+}
+
+void __not_in_flash_func(tmds_update_palette24_pairs)(const uint32_t *palette, uint32_t *tmds_palette, size_t n_palette, uint first, uint count) {
+	assert(first + count <= n_palette);
+	for (uint i = first; i < first + count; ++i) {
+		tmds_palette[i] = tmds_encode_balanced_pair(palette[i] & 0xff);
+		tmds_palette[i + n_palette] = tmds_encode_balanced_pair((palette[i] >> 8) & 0xff);
+		tmds_palette[i + 2 * n_palette] = tmds_encode_balanced_pair((palette[i] >> 16) & 0xff);
+	}
+}
+
+void __not_in_flash_func(tmds_rotate_palette_pairs)(uint32_t *tmds_palette, size_t n_palette, uint first, uint count, int steps) {
+	rotate_palette_tables(tmds_palette, n_palette, 3, first, count, steps);
+}
+
+#if DVI_SYMBOLS_PER_WORD == 2
+typedef void (*tmds_palette_loop_t)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+
+// Common setup for the paletted encoders. The loops differ only in how far
+// they advance through pixbuf for each pair of output symbols; interp1_shift
+// selects which pixel the odd symbol of each pair is taken from. n_sym is the
+// number of output symbols per channel, and n_lanes the number of channels.
+static void __not_in_flash_func(_tmds_encode_palette_data)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf,
+	size_t n_sym, uint32_t palette_bits, uint interp1_shift, tmds_palette_loop_t loop_x, tmds_palette_loop_t loop_y, uint n_lanes) {
+	tmds_palette_loop_t loop = get_core_num() ? loop_x : loop_y;
+
+	// Lane 0 on both interpolators masks the palette bits, starting at bit 2,
+	// The second interpolator also shifts to read the next pixel (full-res), or
+	// reads the same pixel as the first interpolator (pixel-doubled).
+	// Lane 1 shifts and masks the sign bit into the right position to add to the symbol
+	// table index to choose the negative disparity symbols if the sign is negative.
+	// BASE2 is set per channel below, so isn't part of the key.
+	const uint32_t ctrl_lane_1 =
+		((31 - (palette_bits + 2)) << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) |
+		(palette_bits + 2) * ((1 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) | (1 << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB));
+	if (!interp_owner_claim(interp0_hw, INTERP_OWNER_KEY(INTERP_OWNER_TMDS_PALETTE, palette_bits))) {
+		interp0_hw->ctrl[0] =
+			(2 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
+			((palette_bits + 1) << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+		interp0_hw->ctrl[1] = ctrl_lane_1;
+	}
+	if (!interp_owner_claim(interp1_hw, INTERP_OWNER_KEY(INTERP_OWNER_TMDS_PALETTE, palette_bits | interp1_shift << 8))) {
+		interp1_hw->ctrl[0] =
+			(interp1_shift << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) |
+			(2 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
+			((palette_bits + 1) << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+		interp1_hw->ctrl[1] = ctrl_lane_1;
+	}
+
+	// Each channel's symbols are 2 << palette_bits words, positive then negative
+	for (uint lane = 0; lane < n_lanes; ++lane) {
+		interp0_hw->base[2] = (uint32_t)(tmds_palette + (lane << (palette_bits + 1)));
+		interp1_hw->base[2] = (uint32_t)(tmds_palette + (lane << (palette_bits + 1)));
+		loop(pixbuf, symbuf + lane * (n_sym >> 1), n_sym);
+	}
+}
+
 // Encode palette data for all 3 channels.
 // pixbuf is an array of n_pix 8-bit wide pixels containing palette values (32-bit word aligned)
 // tmds_palette is a palette of TMDS symbols produced by tmds_setup_palette_symbols
 // symbuf is 3*n_pix 32-bit words, this function writes the symbol values for each of the channels to it.
 void __not_in_flash_func(tmds_encode_palette_data)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
-	uint core = get_core_num();
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_hw_save_t interp0_save, interp1_save;
-	interp_save(interp0_hw, &interp0_save);
-	interp_save(interp1_hw, &interp1_save);
+	_tmds_encode_palette_data(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, 8,
+		tmds_palette_encode_loop_x, tmds_palette_encode_loop_y, 3);
+}
+
+// As tmds_encode_palette_data, but pixbuf contains 4-bit pixels packed 8 per
+// word, leftmost pixel in the LSBs. palette_bits must be <= 4, and n_pix a
+// multiple of 80.
+void __not_in_flash_func(tmds_encode_palette_data_4bpp)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 4);
+	_tmds_encode_palette_data(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, 4,
+		tmds_palette_encode_loop_ratio4_x, tmds_palette_encode_loop_ratio4_y, 3);
+}
+
+// 2-bit pixels packed 16 per word, leftmost pixel in the LSBs. palette_bits
+// must be <= 2, and n_pix a multiple of 80.
+void __not_in_flash_func(tmds_encode_palette_data_2bpp)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 2);
+	_tmds_encode_palette_data(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, 2,
+		tmds_palette_encode_loop_ratio8_x, tmds_palette_encode_loop_ratio8_y, 3);
+}
+
+// Pixel-doubled versions of the above: n_pix is the number of *input* pixels,
+// and 2*n_pix symbols are written for each channel, so symbuf is 3*n_pix
+// words. Each output pixel is still looked up with its own running disparity,
+// so the colours are exact, but each TMDS symbol costs the same as full-res.
+// 4bpp: n_pix must be a multiple of 40. 2bpp: n_pix must be a multiple of 16.
+void __not_in_flash_func(tmds_encode_palette_data_4bpp_doubled)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 4);
+	_tmds_encode_palette_data(pixbuf, tmds_palette, symbuf, 2 * n_pix, palette_bits, 0,
+		tmds_palette_encode_loop_ratio8_x, tmds_palette_encode_loop_ratio8_y, 3);
+}
+
+void __not_in_flash_func(tmds_encode_palette_data_2bpp_doubled)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 2);
+	_tmds_encode_palette_data(pixbuf, tmds_palette, symbuf, 2 * n_pix, palette_bits, 0,
+		tmds_palette_encode_loop_ratio16_x, tmds_palette_encode_loop_ratio16_y, 3);
+}
+
+typedef void (*tmds_palette_pairs_loop_t)(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint32_t *pairs, uint32_t mask);
+
+static inline void _tmds_encode_palette_pairs(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix,
+	uint32_t palette_bits, tmds_palette_pairs_loop_t loop) {
+	const uint32_t mask = ((1u << palette_bits) - 1) << 2;
+	for (int i = 0; i < 3; ++i)
+		loop(pixbuf, symbuf + i * n_pix, n_pix, tmds_palette + (i << palette_bits), mask);
+}
+
+// Pixel-doubled palette encode using a table of balanced symbol pairs from
+// tmds_setup_palette_pairs. There is no running disparity, and the
+// interpolators are not used. n_pix is the number of *input* pixels, and
+// symbuf is 3*n_pix words (one symbol pair per input pixel per channel).
+// n_pix must be a multiple of the number of pixels per word.
+void __not_in_flash_func(tmds_encode_palette_pairs)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	_tmds_encode_palette_pairs(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, tmds_palette_pairs_loop_8bpp);
+}
+
+void __not_in_flash_func(tmds_encode_palette_pairs_4bpp)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 4);
+	_tmds_encode_palette_pairs(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, tmds_palette_pairs_loop_4bpp);
+}
+
+void __not_in_flash_func(tmds_encode_palette_pairs_2bpp)(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits) {
+	assert(palette_bits <= 2);
+	_tmds_encode_palette_pairs(pixbuf, tmds_palette, symbuf, n_pix, palette_bits, tmds_palette_pairs_loop_2bpp);
+}
 #endif
 
-	interp0_hw->base[2] = (uint32_t)tmds_palette;
-	interp1_hw->base[2] = (uint32_t)tmds_palette;
+// Fill n_pix symbols of each of n_lanes lanes with a single RGB888 colour, as
+// balanced pairs, so no source buffer needs to be read. n_lanes is 3 (blue
+// lane first, as usual), or 1 for DVI_MONOCHROME_TMDS, in which case the
+// green channel is used.
+void __not_in_flash_func(tmds_encode_solid_rgb888)(uint32_t rgb, uint32_t *symbuf, size_t n_pix, uint n_lanes) {
+	size_t words_per_lane = n_pix / DVI_SYMBOLS_PER_WORD;
+	for (uint lane = 0; lane < n_lanes; ++lane) {
+		uint channel = n_lanes == 1 ? 1 : lane;
+		uint32_t pair = tmds_encode_balanced_pair((rgb >> (8 * channel)) & 0xff);
+		uint32_t *out = symbuf + lane * words_per_lane;
+		uint32_t *end = out + words_per_lane;
+#if DVI_SYMBOLS_PER_WORD == 1
+		for (; out < end; out += 2) {
+			out[0] = pair & 0x3ffu;
+			out[1] = pair >> 10;
+		}
+#elif DVI_SYMBOLS_PER_WORD == 3
+		for (; out + 2 <= end; out += 2)
+			put_pairs_3sym(out, pair, pair, pair);
+		// Odd number of words: the last one holds just 3 symbols
+		if (out < end)
+			*out = pair | (pair & 0x3ffu) << 20;
+#else
+		for (; out < end; ++out)
+			*out = pair;
+#endif
+	}
+}
 
-	// Lane 0 on both interpolators masks the palette bits, starting at bit 2,
-	// The second interpolator also shifts to read the 2nd or 4th byte of the word.
-	interp0_hw->ctrl[0] =
-		(2 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
-		((palette_bits + 1) << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
-	interp1_hw->ctrl[0] =
-		(8 << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) |
-		(2 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) |
-		((palette_bits + 1) << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB);
+// ----------------------------------------------------------------------------
+// Greyscale encode, for use with DVI_MONOCHROME_TMDS. These produce a single
+// lane of symbols, which is sent to all three TMDS lanes, so symbuf is a third
+// of the size of the colour encoders' and there is a third of the work.
 
-	// Lane 1 shifts and masks the sign bit into the right position to add to the symbol
-	// table index to choose the negative disparity symbols if the sign is negative.
-	const uint32_t ctrl_lane_1 =
-		((31 - (palette_bits + 2)) << SIO_INTERP0_CTRL_LANE0_SHIFT_LSB) |
-		(palette_bits + 2) * ((1 << SIO_INTERP0_CTRL_LANE0_MASK_LSB_LSB) | (1 << SIO_INTERP0_CTRL_LANE0_MASK_MSB_LSB));
-	interp0_hw->ctrl[1] = ctrl_lane_1;
-	interp1_hw->ctrl[1] = ctrl_lane_1;
+// Pixel values are spread over the full range, so the largest value is white.
+static inline uint8_t grey_level(uint i, uint bits) {
+	return i * 255 / ((1u << bits) - 1);
+}
 
-	if (core) {
-		tmds_palette_encode_loop_x(pixbuf, symbuf, n_pix);
+// Make a table of balanced symbol pairs for pixel-doubled greyscale encode,
+// with 1 << bits entries. Use bits = 8 for tmds_encode_grey_8bpp and bits = 4
+// for tmds_encode_grey_4bpp.
+void tmds_setup_grey_pairs(uint32_t *grey_pairs, uint bits) {
+	assert(bits >= 1 && bits <= 8);
+	for (uint i = 0; i < 1u << bits; ++i)
+		grey_pairs[i] = tmds_encode_balanced_pair(grey_level(i, bits));
+}
 
-		interp0_hw->base[2] = (uint32_t)(tmds_palette + (2 << palette_bits));
-		interp1_hw->base[2] = (uint32_t)(tmds_palette + (2 << palette_bits));
-		tmds_palette_encode_loop_x(pixbuf, symbuf + (n_pix >> 1), n_pix);
+// Make a table of TMDS symbols for full-resolution greyscale encode, in the
+// same format as one channel of tmds_setup_palette_symbols, so 2 << bits words.
+void tmds_setup_grey_symbols(uint32_t *grey_symbols, uint bits) {
+	assert(bits >= 1 && bits <= 8);
+	size_t n = 1u << bits;
+	for (uint i = 0; i < n; ++i)
+		tmds_encode_symbols(grey_level(i, bits), &grey_symbols[i], &grey_symbols[i + n]);
+}
 
-		interp0_hw->base[2] = (uint32_t)(tmds_palette + (4 << palette_bits));
-		interp1_hw->base[2] = (uint32_t)(tmds_palette + (4 << palette_bits));
-		tmds_palette_encode_loop_x(pixbuf, symbuf + n_pix, n_pix);
-	} else {
-		tmds_palette_encode_loop_y(pixbuf, symbuf, n_pix);
+#if DVI_SYMBOLS_PER_WORD == 2
+// Pixel-doubled greyscale encode, with no running disparity and no
+// interpolators. n_pix is the number of *input* pixels, and symbuf is n_pix
+// words. 8bpp: n_pix must be a multiple of 4. 4bpp (packed 8 per word,
+// leftmost pixel in the LSBs): n_pix must be a multiple of 8.
+void __not_in_flash_func(tmds_encode_grey_8bpp)(const uint32_t *pixbuf, const uint32_t *grey_pairs, uint32_t *symbuf, size_t n_pix) {
+	tmds_palette_pairs_loop_8bpp(pixbuf, symbuf, n_pix, grey_pairs, 0xffu << 2);
+}
 
-		interp0_hw->base[2] = (uint32_t)(tmds_palette + (2 << palette_bits));
-		interp1_hw->base[2] = (uint32_t)(tmds_palette + (2 << palette_bits));
-		tmds_palette_encode_loop_y(pixbuf, symbuf + (n_pix >> 1), n_pix);
+void __not_in_flash_func(tmds_encode_grey_4bpp)(const uint32_t *pixbuf, const uint32_t *grey_pairs, uint32_t *symbuf, size_t n_pix) {
+	tmds_palette_pairs_loop_4bpp(pixbuf, symbuf, n_pix, grey_pairs, 0xfu << 2);
+}
+
+// Full-resolution greyscale encode, with running disparity, using the same
+// loops (and the same interpolator setup) as tmds_encode_palette_data. symbuf
+// is n_pix / 2 words. 4bpp: n_pix must be a multiple of 80.
+void __not_in_flash_func(tmds_encode_grey_fullres_8bpp)(const uint32_t *pixbuf, const uint32_t *grey_symbols, uint32_t *symbuf, size_t n_pix) {
+	_tmds_encode_palette_data(pixbuf, grey_symbols, symbuf, n_pix, 8, 8,
+		tmds_palette_encode_loop_x, tmds_palette_encode_loop_y, 1);
+}
 
-		interp0_hw->base[2] = (uint32_t)(tmds_palette + (4 << palette_bits));
-		interp1_hw->base[2] = (uint32_t)(tmds_palette + (4 << palette_bits));
-		tmds_palette_encode_loop_y(pixbuf, symbuf + n_pix, n_pix);
+void __not_in_flash_func(tmds_encode_grey_fullres_4bpp)(const uint32_t *pixbuf, const uint32_t *grey_symbols, uint32_t *symbuf, size_t n_pix) {
+	_tmds_encode_palette_data(pixbuf, grey_symbols, symbuf, n_pix, 4, 4,
+		tmds_palette_encode_loop_ratio4_x, tmds_palette_encode_loop_ratio4_y, 1);
+}
+#endif
+
+// Find the data value nearest to c that has a TMDS symbol with the given
+// disparity, either as-is or inverted. Returns the distance, and the symbol
+// in *sym.
+static int tmds_nearest_with_disparity(uint8_t c, int disparity, uint32_t *sym) {
+	for (int dist = 0; dist < 256; ++dist) {
+		for (int sign = -1; sign <= 1; sign += 2) {
+			int v = c + sign * dist;
+			if (v < 0 || v > 255)
+				continue;
+			uint32_t q_m = tmds_table_qm[v] & 0x1ff;
+			int imbalance = (int16_t)tmds_table_qm[v] >> 10;
+			// Bits 9:8 are 01 or 00 as-is, and 11 or 10 when inverted
+			int disp_noinv = q_m & 0x100 ? imbalance : imbalance - 2;
+			int disp_inv = q_m & 0x100 ? 2 - imbalance : -imbalance;
+			if (disp_noinv == disparity) {
+				*sym = q_m;
+				return dist;
+			}
+			if (disp_inv == disparity) {
+				*sym = q_m ^ 0x2ff;
+				return dist;
+			}
+		}
 	}
+	*sym = 0;
+	return 256;
+}
+
+// Pick even and odd symbols for two colour channel values such that all even
+// symbols have disparity -d and all odd symbols +d, for whichever d gives the
+// closest colours. This generalises the black/white trick used by the 1bpp
+// table (d = 8) and the level choice of the 2bpp table (d = 4).
+static void tmds_1bpp_colour_symbols(uint8_t bg, uint8_t fg, uint32_t even[2], uint32_t odd[2]) {
+	int best_err = 257;
+	for (int d = 8; d >= -8; d -= 2) {
+		uint32_t e[2], o[2];
+		int err = 0;
+		for (int i = 0; i < 2; ++i) {
+			uint8_t c = i ? fg : bg;
+			err = MAX(err, tmds_nearest_with_disparity(c, -d, &e[i]));
+			err = MAX(err, tmds_nearest_with_disparity(c, d, &o[i]));
+		}
+		if (err < best_err) {
+			best_err = err;
+			even[0] = e[0]; even[1] = e[1];
+			odd[0] = o[0]; odd[1] = o[1];
+		}
+	}
+}
 
-#if !TMDS_FULLRES_NO_INTERP_SAVE
-	interp_restore(interp0_hw, &interp0_save);
-	interp_restore(interp1_hw, &interp1_save);
+// Make symbol tables for coloured 1bpp encode. colours holds n_pairs pairs
+// of RGB888 values, background (0 pixels) first, then foreground (1 pixels).
+// tables must be 96 * n_pairs words. The tables for each lane are
+// contiguous: all blue pair tables, then green, then red, 32 words each.
+// Colours are approximated to within a few LSBs, to keep the symbols
+// balanced without any running disparity.
+void tmds_setup_1bpp_colour_tables(const uint32_t *colours, uint32_t *tables, size_t n_pairs) {
+	for (uint lane = 0; lane < 3; ++lane) {
+		for (uint pair = 0; pair < n_pairs; ++pair) {
+			uint32_t even[2], odd[2];
+			tmds_1bpp_colour_symbols(
+				(colours[2 * pair] >> (8 * lane)) & 0xff,
+				(colours[2 * pair + 1] >> (8 * lane)) & 0xff,
+				even, odd
+			);
+			uint32_t *table = tables + 32 * (lane * n_pairs + pair);
+			for (uint i = 0; i < 16; ++i) {
+#if !DVI_1BPP_BIT_REVERSE
+				uint p0 = i & 1, p1 = (i >> 1) & 1, p2 = (i >> 2) & 1, p3 = i >> 3;
+#else
+				uint p0 = i >> 3, p1 = (i >> 2) & 1, p2 = (i >> 1) & 1, p3 = i & 1;
 #endif
+				table[2 * i] = even[p0] | (odd[p1] << 10);
+				table[2 * i + 1] = even[p2] | (odd[p3] << 10);
+			}
+		}
+	}
+}
+
+#if DVI_SYMBOLS_PER_WORD == 2
+// Encode 1bpp data for all 3 channels, in a single colour pair from tables
+// set up by tmds_setup_1bpp_colour_tables. symbuf is 3 * n_pix / 2 words, and
+// n_pix must be a multiple of 32.
+void __not_in_flash_func(tmds_encode_1bpp_colour)(const uint32_t *pixbuf, const uint32_t *colour_tables, uint32_t *symbuf, size_t n_pix, size_t n_pairs, uint pair) {
+	for (uint lane = 0; lane < 3; ++lane)
+		tmds_encode_1bpp_table(pixbuf, symbuf + lane * (n_pix >> 1), n_pix, colour_tables + 32 * (lane * n_pairs + pair));
 }
+
+// As above, but the colour pair changes every span pixels, with span either 8
+// or 32. attrbuf holds one colour pair index per span (word-aligned).
+void __not_in_flash_func(tmds_encode_1bpp_colour_spans)(const uint32_t *pixbuf, const uint8_t *attrbuf, const uint32_t *colour_tables,
+	uint32_t *symbuf, size_t n_pix, size_t n_pairs, uint span) {
+	assert(span == 8 || span == 32);
+	for (uint lane = 0; lane < 3; ++lane) {
+		const uint32_t *lane_tables = colour_tables + 32 * lane * n_pairs;
+		if (span == 8)
+			tmds_encode_1bpp_attr8(pixbuf, symbuf + lane * (n_pix >> 1), n_pix, attrbuf, lane_tables);
+		else
+			tmds_encode_1bpp_attr32(pixbuf, symbuf + lane * (n_pix >> 1), n_pix, attrbuf, lane_tables);
+	}
+}
+#endif
@@ -4,18 +4,55 @@
 #include "hardware/interp.h"
 #include "dvi_config_defs.h"
 
-// Functions from tmds_encode.c
+// Functions from tmds_encode.c. Only the pixel-doubled RGB encoders and
+// tmds_encode_solid_rgb888 support every DVI_SYMBOLS_PER_WORD; the palette,
+// greyscale and 1bpp colour encoders are marked __dvi_2sym_only.
 void tmds_encode_data_channel_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
 void tmds_encode_data_channel_8bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
+void tmds_encode_data_channel_rgb888_dither(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_lsb, uint out_bits, uint y);
 void tmds_encode_data_channel_fullres_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint channel_msb, uint channel_lsb);
 void tmds_setup_palette_symbols(const uint16_t *palette, uint32_t *symbuf, size_t n_palette);
 void tmds_setup_palette24_symbols(const uint32_t *palette, uint32_t *symbuf, size_t n_palette);
-void tmds_encode_palette_data(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+void tmds_update_palette_symbols(const uint16_t *palette, uint32_t *symbuf, size_t n_palette, uint first, uint count);
+void tmds_update_palette24_symbols(const uint32_t *palette, uint32_t *symbuf, size_t n_palette, uint first, uint count);
+void tmds_rotate_palette_symbols(uint32_t *symbuf, size_t n_palette, uint first, uint count, int steps);
+__dvi_2sym_only void tmds_encode_palette_data(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_data_4bpp(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_data_2bpp(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_data_4bpp_doubled(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_data_2bpp_doubled(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+void tmds_setup_palette_pairs(const uint16_t *palette, uint32_t *symbuf, size_t n_palette);
+void tmds_setup_palette24_pairs(const uint32_t *palette, uint32_t *symbuf, size_t n_palette);
+void tmds_update_palette_pairs(const uint16_t *palette, uint32_t *symbuf, size_t n_palette, uint first, uint count);
+void tmds_update_palette24_pairs(const uint32_t *palette, uint32_t *symbuf, size_t n_palette, uint first, uint count);
+void tmds_rotate_palette_pairs(uint32_t *symbuf, size_t n_palette, uint first, uint count, int steps);
+__dvi_2sym_only void tmds_encode_palette_pairs(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_pairs_4bpp(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+__dvi_2sym_only void tmds_encode_palette_pairs_2bpp(const uint32_t *pixbuf, const uint32_t *tmds_palette, uint32_t *symbuf, size_t n_pix, uint32_t palette_bits);
+void tmds_setup_1bpp_colour_tables(const uint32_t *colours, uint32_t *tables, size_t n_pairs);
+__dvi_2sym_only void tmds_encode_1bpp_colour(const uint32_t *pixbuf, const uint32_t *colour_tables, uint32_t *symbuf, size_t n_pix, size_t n_pairs, uint pair);
+__dvi_2sym_only void tmds_encode_1bpp_colour_spans(const uint32_t *pixbuf, const uint8_t *attrbuf, const uint32_t *colour_tables,
+	uint32_t *symbuf, size_t n_pix, size_t n_pairs, uint span);
+void tmds_encode_solid_rgb888(uint32_t rgb, uint32_t *symbuf, size_t n_pix, uint n_lanes);
+void tmds_setup_grey_pairs(uint32_t *grey_pairs, uint bits);
+void tmds_setup_grey_symbols(uint32_t *grey_symbols, uint bits);
+__dvi_2sym_only void tmds_encode_grey_8bpp(const uint32_t *pixbuf, const uint32_t *grey_pairs, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_grey_4bpp(const uint32_t *pixbuf, const uint32_t *grey_pairs, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_grey_fullres_8bpp(const uint32_t *pixbuf, const uint32_t *grey_symbols, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_grey_fullres_4bpp(const uint32_t *pixbuf, const uint32_t *grey_symbols, uint32_t *symbuf, size_t n_pix);
 
-// Functions from tmds_encode.S
+// Functions from tmds_encode.S. The loops which use the interpolators expect
+// them to be configured already, and the caller must claim them first (see
+// interp_owner.h).
 
-void tmds_encode_1bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
-void tmds_encode_2bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_1bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_2bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+__dvi_2sym_only void tmds_encode_1bpp_table(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint32_t *table);
+__dvi_2sym_only void tmds_encode_1bpp_attr8(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint8_t *attrbuf, const uint32_t *tables);
+__dvi_2sym_only void tmds_encode_1bpp_attr32(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint8_t *attrbuf, const uint32_t *tables);
+void tmds_palette_pairs_loop_8bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint32_t *pairs, uint32_t mask);
+void tmds_palette_pairs_loop_4bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint32_t *pairs, uint32_t mask);
+void tmds_palette_pairs_loop_2bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, const uint32_t *pairs, uint32_t mask);
 
 // Uses interp0:
 void tmds_encode_loop_16bpp(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
@@ -33,6 +70,12 @@ void tmds_fullres_encode_loop_16bpp_leftshift_x(const uint32_t *pixbuf, uint32_t
 void tmds_fullres_encode_loop_16bpp_leftshift_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix, uint leftshift);
 void tmds_palette_encode_loop_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
 void tmds_palette_encode_loop_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio4_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio4_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio8_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio8_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio16_x(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
+void tmds_palette_encode_loop_ratio16_y(const uint32_t *pixbuf, uint32_t *symbuf, size_t n_pix);
 
 #if !PICO_RP2040
 // Crank the SIO TMDS encoder:
@@ -2,6 +2,7 @@
 #define _TMDS_ENCODE_FONT_2BPP_H
 
 #include "pico/types.h"
+#include "dvi_config_defs.h"
 
 // Render characters using an 8px-wide font and a per-character 2bpp
 // foreground/background colour. This function is fast enough to run 3 times
@@ -16,8 +17,17 @@
 //
 // font_line: pointer to list of 8 pixel bitmaps, each representing the
 // intersection of a font character with the current scanline. (byte-aligned)
+//
+// n_pix need not be a multiple of 64 (8 characters), but must be a multiple
+// of the character width. Output is two symbols per word.
 
-void tmds_encode_font_2bpp(const uint8_t *charbuf, const uint32_t	*colourbuf,
+__dvi_2sym_only void tmds_encode_font_2bpp(const uint8_t *charbuf, const uint32_t	*colourbuf,
 	uint32_t *tmdsbuf, uint n_pix, const uint8_t *font_line);
 
+// Same, but for a 16px-wide font, so font_line is a list of 16 pixel bitmaps,
+// leftmost pixel in the LSB. (halfword-aligned)
+
+__dvi_2sym_only void tmds_encode_font16_2bpp(const uint8_t *charbuf, const uint32_t	*colourbuf,
+	uint32_t *tmdsbuf, uint n_pix, const uint16_t *font_line);
+
 #endif
@@ -0,0 +1,75 @@
+#include "hardware/dma.h"
+#include "tmds_encode_pio.h"
+#include "tmds_encode_1bpp.pio.h"
+#include "tmds_encode_2bpp.pio.h"
+
+#if DVI_SYMBOLS_PER_WORD == 2
+
+void tmds_pio_encoder_init(struct tmds_pio_encoder *enc, PIO pio, uint n_lanes, uint bpp, bool doubled, uint n_pix) {
+	assert(n_lanes >= 1 && n_lanes <= N_TMDS_LANES);
+	assert(bpp == 1 || bpp == 2);
+	// Every line must be whole input words
+	assert((doubled ? n_pix / 2 : n_pix) * bpp % 32 == 0);
+	enc->pio = pio;
+	enc->n_lanes = n_lanes;
+	enc->bpp = bpp;
+	enc->doubled = doubled;
+	enc->n_pix = n_pix;
+
+	if (bpp == 1)
+		enc->program = doubled ? &tmds_encode_1bpp_doubled_program : &tmds_encode_1bpp_program;
+	else
+		enc->program = doubled ? &tmds_encode_2bpp_doubled_program : &tmds_encode_2bpp_program;
+	if (!pio_can_add_program(pio, enc->program))
+		panic("No room for TMDS encode program (2bpp can't share a PIO with the serialiser)");
+	enc->program_offset = pio_add_program(pio, enc->program);
+
+	for (uint lane = 0; lane < n_lanes; ++lane) {
+		uint sm = pio_claim_unused_sm(pio, true);
+		enc->sm[lane] = sm;
+		if (bpp == 1 && doubled)
+			tmds_encode_1bpp_doubled_program_init(pio, sm, enc->program_offset);
+		else if (bpp == 1)
+			tmds_encode_1bpp_program_init(pio, sm, enc->program_offset);
+		else if (doubled)
+			tmds_encode_2bpp_doubled_program_init(pio, sm, enc->program_offset);
+		else
+			tmds_encode_2bpp_program_init(pio, sm, enc->program_offset);
+
+		enc->dma_chan_put[lane] = dma_claim_unused_channel(true);
+		dma_channel_config c = dma_channel_get_default_config(enc->dma_chan_put[lane]);
+		channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+		dma_channel_configure(enc->dma_chan_put[lane], &c,
+			&pio->txf[sm],
+			NULL,
+			(doubled ? n_pix / 2 : n_pix) * bpp / 32,
+			false
+		);
+
+		enc->dma_chan_get[lane] = dma_claim_unused_channel(true);
+		c = dma_channel_get_default_config(enc->dma_chan_get[lane]);
+		channel_config_set_dreq(&c, pio_get_dreq(pio, sm, false));
+		channel_config_set_write_increment(&c, true);
+		channel_config_set_read_increment(&c, false);
+		dma_channel_configure(enc->dma_chan_get[lane], &c,
+			NULL,
+			&pio->rxf[sm],
+			n_pix / DVI_SYMBOLS_PER_WORD,
+			false
+		);
+	}
+}
+
+void __not_in_flash_func(tmds_pio_encode_start)(struct tmds_pio_encoder *enc, const uint32_t *const *planes, uint32_t *tmdsbuf) {
+	for (uint lane = 0; lane < enc->n_lanes; ++lane) {
+		dma_channel_set_write_addr(enc->dma_chan_get[lane], tmdsbuf + lane * (enc->n_pix / DVI_SYMBOLS_PER_WORD), true);
+		dma_channel_set_read_addr(enc->dma_chan_put[lane], planes[lane], true);
+	}
+}
+
+void __not_in_flash_func(tmds_pio_encode_wait)(const struct tmds_pio_encoder *enc) {
+	for (uint lane = 0; lane < enc->n_lanes; ++lane)
+		dma_channel_wait_for_finish_blocking(enc->dma_chan_get[lane]);
+}
+
+#endif
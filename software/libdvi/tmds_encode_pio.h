@@ -0,0 +1,54 @@
+#ifndef _TMDS_ENCODE_PIO_H
+#define _TMDS_ENCODE_PIO_H
+
+#include "hardware/pio.h"
+#include "dvi_serialiser.h"
+
+// Offload TMDS encode of 1bpp or 2bpp bitplanes to PIO state machines, with
+// DMA moving pixels in and symbols out, so no CPU time is spent on encode.
+// There is one state machine per lane, so with 3 lanes this can encode
+// planar RGB111 (1bpp) or RGB222 (2bpp), and with 1 lane it can encode black
+// and white or 4-level greyscale for DVI_MONOCHROME_TMDS. (Greyscale on a
+// colour build just passes the same plane for all three lanes.)
+//
+// 1bpp uses the same symbols as tmds_encode_1bpp(). 2bpp uses zero-balance
+// symbols with levels of roughly 255 * (1/16, 3/8, 5/8, 15/16), which is
+// lower contrast than tmds_encode_2bpp().
+//
+// If doubled is true, each input pixel fills a whole symbol pair, so the
+// planes are half the display width.
+//
+// The 2bpp programs must be loaded at PIO offset 0, so can't share a PIO
+// with the DVI serialiser. With 3 lanes you need a PIO with 3 free state
+// machines anyway, so in both cases pass the PIO the serialiser isn't using.
+
+struct tmds_pio_encoder {
+	PIO pio;
+	uint n_lanes;
+	uint bpp;
+	bool doubled;
+	// Output pixels per lane, i.e. display width
+	uint n_pix;
+	const pio_program_t *program;
+	uint program_offset;
+	uint sm[N_TMDS_LANES];
+	uint dma_chan_put[N_TMDS_LANES];
+	uint dma_chan_get[N_TMDS_LANES];
+};
+
+// Load the program, and claim state machines and DMA channels. The programs
+// produce two symbols per word, so this needs DVI_SYMBOLS_PER_WORD == 2.
+__dvi_2sym_only void tmds_pio_encoder_init(struct tmds_pio_encoder *enc, PIO pio, uint n_lanes, uint bpp, bool doubled, uint n_pix);
+
+// Start encoding planes[i] into lane i of tmdsbuf (lane stride n_pix / 2
+// words), and return immediately. Each plane must be word-aligned.
+void tmds_pio_encode_start(struct tmds_pio_encoder *enc, const uint32_t *const *planes, uint32_t *tmdsbuf);
+
+void tmds_pio_encode_wait(const struct tmds_pio_encoder *enc);
+
+static inline void tmds_pio_encode(struct tmds_pio_encoder *enc, const uint32_t *const *planes, uint32_t *tmdsbuf) {
+	tmds_pio_encode_start(enc, planes, tmdsbuf);
+	tmds_pio_encode_wait(enc);
+}
+
+#endif
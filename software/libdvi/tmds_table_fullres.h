@@ -1,139 +0,0 @@
-// Each entry consists of a 10 bit TMDS symbol in pseudo-differential format
-// (10 LSBs) and the symbol's disparity as a 6 bit signed integer (the 6
-// MSBs). There is a 16 bit gap in between them, which is actually vital for
-// the way the TMDS encode works!
-//
-// There are 128 1-word entries. The lookup index should be the concatenation
-// of the sign bit of current running disparity, with 6 bits of colour channel
-// data.
-
-// Non-negative running disparity:
-0xe0000100,
-0xf8000303,
-0x00000307,
-0xe8000104,
-0x000001f0,
-0xf000010c,
-0xe8000108,
-0x0000030b,
-0xf80001e0,
-0xf800011c,
-0xf0000118,
-0x000001e4,
-0xe8000110,
-0x00000313,
-0x000001e8,
-0xf0000241,
-0xf00001c0,
-0x0000013c,
-0xf8000138,
-0xf80001c4,
-0xf0000130,
-0x000001cc,
-0xf80001c8,
-0xf8000261,
-0xe8000120,
-0x00000323,
-0x000001d8,
-0x00000271,
-0xf80001d0,
-0xf0000086,
-0xe8000082,
-0xf0000281,
-0xe8000180,
-0x00000383,
-0x00000178,
-0xf0000184,
-0xf8000170,
-0xf800018c,
-0xf0000188,
-0xf0000221,
-0xf0000160,
-0x0000019c,
-0xf8000198,
-0xf8000231,
-0xf0000190,
-0x00000239,
-0xf00000c2,
-0xf80002c1,
-0xe8000140,
-0x00000343,
-0x000001b8,
-0xf0000211,
-0xf80001b0,
-0xf8000219,
-0x0000021d,
-0x000002e1,
-0xf00001a0,
-0xf0000209,
-0xf800020d,
-0xf000000e,
-0xf0000205,
-0xe8000006,
-0xe0000002,
-0xe8000201,
-// Negative running disparity:
-0x280003ff,
-0x100001fc,
-0x080001f8,
-0x200003fb,
-0x000001f0,
-0x180003f3,
-0x200003f7,
-0x080001f4,
-0x1000031f,
-0x100003e3,
-0x180003e7,
-0x000001e4,
-0x200003ef,
-0x080001ec,
-0x000001e8,
-0x080000be,
-0x1800033f,
-0x0000013c,
-0x100003c7,
-0x1000033b,
-0x180003cf,
-0x000001cc,
-0x10000337,
-0x0000009e,
-0x200003df,
-0x080001dc,
-0x000001d8,
-0x00000271,
-0x1000032f,
-0x08000279,
-0x1000027d,
-0x0800007e,
-0x2000037f,
-0x0800017c,
-0x00000178,
-0x1800037b,
-0x1000038f,
-0x10000373,
-0x18000377,
-0x080000de,
-0x1800039f,
-0x0000019c,
-0x10000367,
-0x000000ce,
-0x1800036f,
-0x00000239,
-0x0800023d,
-0x0000003e,
-0x200003bf,
-0x080001bc,
-0x000001b8,
-0x080000ee,
-0x1000034f,
-0x000000e6,
-0x0000021d,
-0x000002e1,
-0x1800035f,
-0x080000f6,
-0x000000f2,
-0x080002f1,
-0x080000fa,
-0x100002f9,
-0x180002fd,
-0x100000fe,
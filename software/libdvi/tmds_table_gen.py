@@ -6,11 +6,21 @@
 #
 # This is a reasonable constraint, because we only want RGB565 (so 6 valid
 # channel data bits -> data is multiple of 4), and can probably tolerate
-# 0.25LSB of noise :)
+# 0.25LSB of noise :) (7 and 8 bit tables lose their LSB.)
 #
 # This means that encoding a half-horizontal-resolution scanline buffer is a
 # simple LUT operation for each colour channel, because we have made the
 # encoding process stateless by guaranteeing 0 balance.
+#
+# The build generates the doubled, fullres and qm tables with e.g.
+#
+#   tmds_table_gen.py doubled --bits 5 -o tmds_table.h
+#
+# for each app's TMDS_TABLE_BITS and TMDS_FULLRES_TABLE_BITS (see
+# libdvi_tmds_table_bits() in CMakeLists.txt).
+
+import argparse
+import sys
 
 def popcount(x):
 	n = 0
@@ -78,17 +88,38 @@ def differentialise(x, n):
 		x <<= 1
 	return accum
 
-enc = TMDSEncode()
-
+# Channel data is left-justified in the 8 bit TMDS data, the same as the
+# palette code does for e.g. RGB565, so a b bit table covers 0 to
+# 256 - 2 ** (8 - b).
+def channel_data(v, bits):
+	return v << (8 - bits)
 
 ###
 # Pixel-doubled table:
 
-# for i in range(0, 256, 4):
-# 	sym0 = enc.encode(i, 0, 1)
-# 	sym1 = enc.encode(i ^ 1, 0, 1)
-# 	assert(enc.imbalance == 0)
-# 	print(f"0x{sym0 | (sym1 << 10):05x}u,")
+def table_doubled(bits):
+	lines = [
+		"// Generated from tmds_table_gen.py",
+		"//",
+		f"// This table converts a {bits} bit data input into a pair of TMDS data symbols",
+		f"// with data content *almost* equal (1 LSB off) to input value left shifted by",
+		f"// {8 - bits}. The pairs of symbols have a net DC balance of 0.",
+		"//",
+		"// The two symbols are concatenated in the 20 LSBs of a data word, with the",
+		"// first symbol in least-significant position.",
+		"//",
+		"// Note the declaration isn't included here, just the table body. This is in",
+		"// case you want multiple copies of the table in different SRAMs (particularly",
+		"// scratch X/Y).",
+	]
+	enc = TMDSEncode()
+	for v in range(1 << bits):
+		i = channel_data(v, bits) & ~1
+		sym0 = enc.encode(i, 0, 1)
+		sym1 = enc.encode(i ^ 1, 0, 1)
+		assert(enc.imbalance == 0)
+		lines.append(f"0x{sym0 | (sym1 << 10):05x}u,")
+	return lines
 
 ###
 # Fullres 1bpp table: (each entry is 2 words, 4 pixels)
@@ -98,53 +129,134 @@ enc = TMDSEncode()
 # (two pairs of dark/light colours. Creates some fairly subtle vertical
 # (banding, but it's cheap.
 
-# for i in range(1 << 4):
-# 	syms = list(enc.encode((0xff if i & 1 << j else 0) ^ j & 0x01, 0, 1) for j in range(4))
-# 	print(f"0x{syms[0] | syms[1] << 10:05x}, 0x{syms[2] | syms[3] << 10:05x}")
-# 	assert(enc.imbalance == 0)
+def table_1bpp():
+	enc = TMDSEncode()
+	lines = []
+	for i in range(1 << 4):
+		syms = list(enc.encode((0xff if i & 1 << j else 0) ^ j & 0x01, 0, 1) for j in range(4))
+		lines.append(f"0x{syms[0] | syms[1] << 10:05x}, 0x{syms[2] | syms[3] << 10:05x}")
+		assert(enc.imbalance == 0)
+	return lines
 
 ###
 # Fullres table stuff:
 
-# def disptable_format(sym):
-# 	return sym | ((popcount(sym) * 2 - 10 & 0x3f) << 26)
+def disptable_format(sym):
+	return sym | ((popcount(sym) * 2 - 10 & 0x3f) << 26)
+
+def table_fullres(bits):
+	lines = [
+		"// Generated from tmds_table_gen.py",
+		"//",
+		"// Each entry consists of a 10 bit TMDS symbol in pseudo-differential format",
+		"// (10 LSBs) and the symbol's disparity as a 6 bit signed integer (the 6",
+		"// MSBs). There is a 16 bit gap in between them, which is actually vital for",
+		"// the way the TMDS encode works!",
+		"//",
+		f"// There are {2 << bits} 1-word entries. The lookup index should be the concatenation",
+		f"// of the sign bit of current running disparity, with {bits} bits of colour channel",
+		"// data.",
+		"",
+	]
+	enc = TMDSEncode()
+	lines.append("// Non-negative running disparity:")
+	for v in range(1 << bits):
+		enc.imbalance = 1
+		lines.append("0x{:08x},".format(disptable_format(enc.encode(channel_data(v, bits), 0, 1))))
+	lines.append("// Negative running disparity:")
+	for v in range(1 << bits):
+		enc.imbalance = -1
+		lines.append("0x{:08x},".format(disptable_format(enc.encode(channel_data(v, bits), 0, 1))))
+	return lines
 
-# print("// Non-negative running disparity:")
-# for i in range(0, 256, 4):
-# 	enc.imbalance = 1
-# 	print("0x{:08x},".format(disptable_format(enc.encode(i, 0, 1))))
+###
+# Transition-minimised table, for building palettes at runtime:
 
-# print("// Negative running disparity:")
-# for i in range(0, 256, 4):
-# 	enc.imbalance = -1
-# 	print("0x{:08x},".format(disptable_format(enc.encode(i, 0, 1))))
+def table_qm():
+	lines = [
+		"// Generated from tmds_table_gen.py",
+		"//",
+		"// This table gives the transition-minimised form q_m of each 8 bit data value",
+		"// (9 LSBs), and the imbalance of q_m[7:0] as a 6 bit signed integer (the 6",
+		"// MSBs). DC balancing is left to the caller, so the palette setup code can",
+		"// make both the positive and negative disparity symbols from one lookup.",
+		"",
+	]
+	enc = TMDSEncode()
+	for i in range(256):
+		enc.imbalance = 0
+		sym = enc.encode(i, 0, 1)
+		q_m = sym ^ (0 if sym & 0x100 else 0x2ff)
+		lines.append(f"0x{q_m | (byteimbalance(q_m & 0xff) & 0x3f) << 10:04x}u,")
+	return lines
 
 ###
 # Control symbols:
 
-# for i in range(4):
-# 	sym = enc.encode(0, i, 0)
-# 	print(f"0x{sym << 10 | sym:05x},")
-
+def table_ctrl():
+	enc = TMDSEncode()
+	return [f"0x{enc.encode(0, i, 0) << 10 | enc.encode(0, i, 0):05x}," for i in range(4)]
 
 ###
 # Find zero-balance symbols:
 
-# for i in range(256):
-# 	enc.imbalance = 0
-# 	sym = enc.encode(i, 0, 1)
-# 	if enc.imbalance == 0:
-# 		print(f"{i:02x}: {sym:03x}")
+def zero_balance():
+	enc = TMDSEncode()
+	lines = []
+	for i in range(256):
+		enc.imbalance = 0
+		sym = enc.encode(i, 0, 1)
+		if enc.imbalance == 0:
+			lines.append(f"{i:02x}: {sym:03x}")
+	return lines
 
 ###
 # Generate 2bpp table based on above experiment:
 
-levels_2bpp_even = [0x05, 0x50, 0xaf, 0xfa]
-levels_2bpp_odd  = [0x04, 0x51, 0xae, 0xfb]
+def table_2bpp():
+	enc = TMDSEncode()
+	levels_2bpp_even = [0x05, 0x50, 0xaf, 0xfa]
+	levels_2bpp_odd  = [0x04, 0x51, 0xae, 0xfb]
+	lines = []
+	for i1, p1 in enumerate(levels_2bpp_odd):
+		for i0, p0 in enumerate(levels_2bpp_even):
+			sym0 = enc.encode(p0, 0, 1)
+			sym1 = enc.encode(p1, 0, 1)
+			assert(enc.imbalance == 0)
+			lines.append(f".word 0x{sym1 << 10 | sym0:05x} // {i0:02b}, {i1:02b}")
+	return lines
 
-for i1, p1 in enumerate(levels_2bpp_odd):
-	for i0, p0 in enumerate(levels_2bpp_even):
-		sym0 = enc.encode(p0, 0, 1)
-		sym1 = enc.encode(p1, 0, 1)
-		assert(enc.imbalance == 0)
-		print(f".word 0x{sym1 << 10 | sym0:05x} // {i0:02b}, {i1:02b}")
+# The doubled, fullres and qm tables are generated at build time by
+# libdvi/CMakeLists.txt. The rest are for pasting into the source by hand.
+TABLES = {
+	"doubled": table_doubled,
+	"fullres": table_fullres,
+	"qm": table_qm,
+	"1bpp": table_1bpp,
+	"ctrl": table_ctrl,
+	"zero-balance": zero_balance,
+	"2bpp": table_2bpp,
+}
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser()
+	parser.add_argument("table", choices=TABLES.keys(), help="Which table to generate")
+	parser.add_argument("--bits", "-b", type=int, default=6,
+		help="Channel width for the doubled and fullres tables, 1 to 8 (default 6)")
+	parser.add_argument("--output", "-o", help="Output file (default stdout)")
+	args = parser.parse_args()
+	if not 1 <= args.bits <= 8:
+		parser.error("--bits must be between 1 and 8")
+	gen = TABLES[args.table]
+	lines = gen(args.bits) if args.table in ("doubled", "fullres") else gen()
+	text = "\n".join(lines) + "\n"
+	if args.output:
+		# Don't touch the output if it hasn't changed, to avoid needless rebuilds
+		try:
+			if open(args.output).read() == text:
+				sys.exit(0)
+		except FileNotFoundError:
+			pass
+		open(args.output, "w").write(text)
+	else:
+		sys.stdout.write(text)
@@ -0,0 +1,5 @@
+#include "interp_owner.h"
+
+// Zero (INTERP_OWNER_NONE) at reset, so the first claim on each interpolator
+// always configures it.
+uint32_t interp_owner_keys[NUM_CORES][INTERP_OWNER_NUM_INTERPS];
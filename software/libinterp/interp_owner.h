@@ -0,0 +1,61 @@
+#ifndef _INTERP_OWNER_H
+#define _INTERP_OWNER_H
+
+#include "pico.h"
+#include "hardware/interp.h"
+
+// Record of what each interpolator on each core is currently configured for,
+// so that kernels sharing a core (e.g. TMDS encode, tiles and sprites) can
+// use the interpolators without saving and restoring them around every call.
+//
+// Before using an interpolator, a kernel calls interp_owner_claim() with a key
+// for the configuration it needs: a kernel ID plus whichever parameters end
+// up in the CTRL and BASE registers that the kernel relies on persisting. If
+// the interpolator on this core is already in that configuration, the kernel
+// can skip its setup. Registers that change on every call (the accumulators,
+// and e.g. a per-scanline BASE2) are not part of the key, and the kernel must
+// always write them.
+//
+// Code outside of libdvi and libsprite which uses the interpolators directly
+// must either claim them with its own keys (IDs from INTERP_OWNER_USER
+// upward), or call interp_owner_invalidate() when it's done. Interrupt
+// handlers must still save/restore any interpolator they use, and must not
+// claim them.
+
+#define INTERP_OWNER_NUM_INTERPS 2
+
+enum interp_owner_id {
+	INTERP_OWNER_NONE = 0,
+	INTERP_OWNER_TMDS_ADDRGEN,
+	INTERP_OWNER_TMDS_FULLRES,
+	INTERP_OWNER_TMDS_PALETTE,
+	INTERP_OWNER_TILE_PTRS,
+	INTERP_OWNER_SPRITE_COORDGEN,
+	INTERP_OWNER_USER = 0x80
+};
+
+// Kernel ID in the top 8 bits, up to 24 bits of configuration parameters
+#define INTERP_OWNER_KEY(id, params) ((uint32_t)(id) << 24 | ((uint32_t)(params) & 0xffffffu))
+
+extern uint32_t interp_owner_keys[NUM_CORES][INTERP_OWNER_NUM_INTERPS];
+
+// Returns true if this core's interp is already configured as described by
+// key, so setup can be skipped. Otherwise records key as the interpolator's
+// new configuration and returns false, and the caller must configure it.
+static inline bool interp_owner_claim(interp_hw_t *interp, uint32_t key) {
+	uint32_t *owner = &interp_owner_keys[get_core_num()][interp_index(interp)];
+	if (*owner == key)
+		return true;
+	*owner = key;
+	return false;
+}
+
+// Forget the configuration of both interpolators on this core, so the next
+// kernel to claim each one will set it up from scratch.
+static inline void interp_owner_invalidate(void) {
+	uint core = get_core_num();
+	for (uint i = 0; i < INTERP_OWNER_NUM_INTERPS; ++i)
+		interp_owner_keys[core][i] = INTERP_OWNER_NONE;
+}
+
+#endif
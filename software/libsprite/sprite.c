@@ -3,6 +3,7 @@
 
 #include "pico.h" // for __not_in_flash
 #include "hardware/interp.h"
+#include "interp_owner.h"
 
 // Note some of the sprite routines are quite large (unrolled), so trying to
 // keep everything in separate sections so the linker can garbage collect
@@ -19,20 +20,24 @@ typedef struct {
 static inline intersect_t _get_sprite_intersect(const sprite_t *sp, uint raster_y, uint raster_w) {
 	intersect_t isct = {0};
 	isct.tex_offs_y = (int)raster_y - sp->y;
-	int size = 1u << sp->log_size;
-	uint upper_mask = -size;
-	if ((uint)isct.tex_offs_y & upper_mask)
+	if ((uint)isct.tex_offs_y >= sp->height)
 		return isct;
 	int x_start_clipped = MAX(0, sp->x);
 	isct.tex_offs_x = x_start_clipped - sp->x;
-	isct.size_x = MIN(sp->x + size, (int)raster_w) - x_start_clipped;
+	isct.size_x = MIN(sp->x + sp->width, (int)raster_w) - x_start_clipped;
 	return isct;
 }
 
 // Sprites may have an array of metadata on the end. One word per line, encodes first opaque pixel, last opaque pixel, and whether the span in between is solid. This allows fewer 
-static inline intersect_t _intersect_with_metadata(intersect_t isct, uint32_t meta) {
+// The metadata is in texture order, so mirror it first if the sprite is flipped.
+static inline intersect_t _intersect_with_metadata(intersect_t isct, uint32_t meta, bool hflip, int width) {
 	int span_end = meta & 0xffff;
 	int span_start = (meta >> 16) & 0x7fff;
+	if (hflip) {
+		int mirrored_start = width - span_end;
+		span_end = width - span_start;
+		span_start = mirrored_start;
+	}
 	int isct_new_start = MAX(isct.tex_offs_x, span_start);
 	int isct_new_end = MIN(isct.tex_offs_x + isct.size_x, span_end);
 	isct.tex_offs_x = isct_new_start;
@@ -40,55 +45,81 @@ static inline intersect_t _intersect_with_metadata(intersect_t isct, uint32_t me
 	return isct;
 }
 
+// isct.tex_offs_x counts from the sprite's left edge on screen. For a flipped
+// sprite, the blit reads the row backward starting from the texture pixel
+// under the rightmost screen pixel.
+static inline int _hflip_src_offs(const sprite_t *sp, intersect_t isct) {
+	return sp->hflip ? sp->width - isct.tex_offs_x - isct.size_x : isct.tex_offs_x;
+}
+
+// Metadata is one word per row, after the last row of pixel data
+static inline const uint32_t *_sprite_metadata(const sprite_t *sp, uint stride, uint bytes_per_pixel) {
+	uintptr_t end = (uintptr_t)sp->img + stride * sp->height * bytes_per_pixel;
+	return (const uint32_t*)((end + 3) & ~(uintptr_t)3);
+}
+
 void __ram_func(sprite_sprite8)(uint8_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w) {
-	int size = 1u << sp->log_size;
+	uint stride = sprite_stride(sp);
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
 	if (isct.size_x <= 0)
 		return;
 	if (sp->vflip)
-		isct.tex_offs_y = size - 1 - isct.tex_offs_y;
+		isct.tex_offs_y = sp->height - 1 - isct.tex_offs_y;
 	const uint8_t *img = sp->img;
+	bool span_continuous = false;
 	if (sp->has_opacity_metadata) {
-		// Metadata is one word per row, concatenated to end of pixel data
-		uint32_t meta = ((uint32_t*)(sp->img + size * size * sizeof(uint8_t)))[isct.tex_offs_y];
-		isct = _intersect_with_metadata(isct, meta);
+		uint32_t meta = _sprite_metadata(sp, stride, sizeof(uint8_t))[isct.tex_offs_y];
+		isct = _intersect_with_metadata(isct, meta, sp->hflip, sp->width);
 		if (isct.size_x <= 0)
 			return;
-		bool span_continuous = !!(meta & (1u << 31));
-		if (span_continuous) {
-			// Non-alpha blit is ~50% faster
-			sprite_blit8(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
-		}
-		else {
-			sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
-		}
+		span_continuous = !!(meta & (1u << 31));
+	}
+	uint8_t *dst = scanbuf + sp->x + isct.tex_offs_x;
+	const uint8_t *src = img + _hflip_src_offs(sp, isct) + isct.tex_offs_y * stride;
+	// Non-alpha blit is ~50% faster
+	if (sp->hflip) {
+		if (span_continuous)
+			sprite_blit8_hflip(dst, src, isct.size_x);
+		else
+			sprite_blit8_alpha_hflip(dst, src, isct.size_x);
 	}
 	else {
-		sprite_blit8_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+		if (span_continuous)
+			sprite_blit8(dst, src, isct.size_x);
+		else
+			sprite_blit8_alpha(dst, src, isct.size_x);
 	}
 }
 
 void __ram_func(sprite_sprite16)(uint16_t *scanbuf, const sprite_t *sp, uint raster_y, uint raster_w) {
-	int size = 1u << sp->log_size;
+	uint stride = sprite_stride(sp);
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
 	if (isct.size_x <= 0)
 		return;
 	if (sp->vflip)
-		isct.tex_offs_y = size - 1 - isct.tex_offs_y;
+		isct.tex_offs_y = sp->height - 1 - isct.tex_offs_y;
 	const uint16_t *img = sp->img;
+	bool span_continuous = false;
 	if (sp->has_opacity_metadata) {
-		uint32_t meta = ((uint32_t*)(sp->img + size * size * sizeof(uint16_t)))[isct.tex_offs_y];
-		isct = _intersect_with_metadata(isct, meta);
+		uint32_t meta = _sprite_metadata(sp, stride, sizeof(uint16_t))[isct.tex_offs_y];
+		isct = _intersect_with_metadata(isct, meta, sp->hflip, sp->width);
 		if (isct.size_x <= 0)
 			return;
-		bool span_continuous = !!(meta & (1u << 31));
+		span_continuous = !!(meta & (1u << 31));
+	}
+	uint16_t *dst = scanbuf + sp->x + isct.tex_offs_x;
+	const uint16_t *src = img + _hflip_src_offs(sp, isct) + isct.tex_offs_y * stride;
+	if (sp->hflip) {
 		if (span_continuous)
-			sprite_blit16(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit16_hflip(dst, src, isct.size_x);
 		else
-			sprite_blit16_alpha(scanbuf + sp->x + isct.tex_offs_x, img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+			sprite_blit16_alpha_hflip(dst, src, isct.size_x);
 	}
 	else {
-		sprite_blit16_alpha(scanbuf + MAX(0, sp->x), img + isct.tex_offs_x + isct.tex_offs_y * size, isct.size_x);
+		if (span_continuous)
+			sprite_blit16(dst, src, isct.size_x);
+		else
+			sprite_blit16_alpha(dst, src, isct.size_x);
 	}
 }
 
@@ -119,6 +150,12 @@ static inline __attribute__((always_inline)) void _setup_interp_affine(interp_hw
 	interp->base[1] = -atrans[3]; // -a10
 }
 
+// Smallest n >= 1 with (1 << n) >= x, i.e. the number of texture coordinate
+// bits the interpolator keeps for a sprite dimension of x pixels
+static inline uint _sprite_coord_bits(uint x) {
+	return x <= 2 ? 1 : 32 - __builtin_clz(x - 1);
+}
+
 // Set up an interpolator to generate pixel lookup addresses from fp1616
 // numbers in accum1, accum0 based on the parameters of sprite sp and the size
 // of the individual pixels
@@ -127,42 +164,196 @@ static inline __attribute__((always_inline)) void _setup_interp_pix_coordgen(int
 	// to index the sprite texture in both directions. Reading from POP_FULL will
 	// yields these bits, added to sp->img, and this will also trigger BASE0 and
 	// BASE1 to be directly added (thanks to CTRL_ADD_RAW) to the accumulators,
-	// which generates the u,v coordinate for the *next* read.
-	assert(sp->log_size + pixel_shift <= 16);
+	// which generates the u,v coordinate for the *next* read. The v bits are
+	// shifted up to the row stride, so the stride must be a power of two.
+	uint stride = sprite_stride(sp);
+	assert(!(stride & (stride - 1)));
+	uint log_stride = __builtin_ctz(stride);
+	uint u_bits = _sprite_coord_bits(sp->width);
+	uint v_bits = _sprite_coord_bits(sp->height);
+	assert(log_stride + pixel_shift <= 16);
 
-	interp_config c0 = interp_default_config();
-	interp_config_set_add_raw(&c0, true);
-	interp_config_set_shift(&c0, 16 - pixel_shift);
-	interp_config_set_mask(&c0, pixel_shift, pixel_shift + sp->log_size - 1);
-	interp_set_config(interp, 0, &c0);
+	if (!interp_owner_claim(interp, INTERP_OWNER_KEY(INTERP_OWNER_SPRITE_COORDGEN,
+			u_bits | v_bits << 5 | log_stride << 10 | pixel_shift << 15))) {
+		interp_config c0 = interp_default_config();
+		interp_config_set_add_raw(&c0, true);
+		interp_config_set_shift(&c0, 16 - pixel_shift);
+		interp_config_set_mask(&c0, pixel_shift, pixel_shift + u_bits - 1);
+		interp_set_config(interp, 0, &c0);
 
-	interp_config c1 = interp_default_config();
-	interp_config_set_add_raw(&c1, true);
-	interp_config_set_shift(&c1, 16 - sp->log_size - pixel_shift);
-	interp_config_set_mask(&c1, pixel_shift + sp->log_size, pixel_shift + 2 * sp->log_size - 1);
-	interp_set_config(interp, 1, &c1);
+		interp_config c1 = interp_default_config();
+		interp_config_set_add_raw(&c1, true);
+		interp_config_set_shift(&c1, 16 - log_stride - pixel_shift);
+		interp_config_set_mask(&c1, pixel_shift + log_stride, pixel_shift + log_stride + v_bits - 1);
+		interp_set_config(interp, 1, &c1);
+	}
 
 	interp->base[2] = (uint32_t)sp->img;
 }
 
-// Note we do NOT save/restore the interpolator!
+static inline int32_t _floor_div(int32_t n, int32_t d) {
+	return n >= 0 ? n / d : -((d - 1 - n) / d);
+}
+
+static inline int32_t _ceil_div(int32_t n, int32_t d) {
+	return -_floor_div(-n, d);
+}
+
+// Narrow [*lo, *hi) to the x for which 0 <= a * x + c < limit
+static inline void _clip_linear(int *lo, int *hi, int32_t a, int32_t c, int32_t limit) {
+	int32_t first, end;
+	if (a > 0) {
+		first = _ceil_div(-c, a);
+		end = _ceil_div(limit - c, a);
+	}
+	else if (a < 0) {
+		first = _floor_div(c - limit, -a) + 1;
+		end = _floor_div(c, -a) + 1;
+	}
+	else {
+		if (c < 0 || c >= limit)
+			*hi = *lo;
+		return;
+	}
+	*lo = MAX(*lo, first);
+	*hi = MIN(*hi, end);
+}
+
+// The interpolator flags samples outside of the power-of-two box around the
+// texture, and the loops skip them, so a power-of-two texture is already
+// clipped (it does not tile or wrap). For other sizes, trim the span to the
+// pixels which sample inside the texture, using the same coordinates as
+// _setup_interp_affine: raster pixel x samples at x + 1, since the span is
+// walked backward.
+static inline intersect_t _clip_affine_to_texture(intersect_t isct, const sprite_t *sp, const affine_transform_t atrans) {
+	if (sp->width == 1u << _sprite_coord_bits(sp->width) && sp->height == 1u << _sprite_coord_bits(sp->height))
+		return isct;
+	int lo = isct.tex_offs_x;
+	int hi = isct.tex_offs_x + isct.size_x;
+	int32_t u_c = atrans[0] + mul_fp1616(atrans[1], isct.tex_offs_y * AF_ONE) + atrans[2];
+	int32_t v_c = atrans[3] + mul_fp1616(atrans[4], isct.tex_offs_y * AF_ONE) + atrans[5];
+	_clip_linear(&lo, &hi, atrans[0], u_c, sp->width * AF_ONE);
+	_clip_linear(&lo, &hi, atrans[3], v_c, sp->height * AF_ONE);
+	isct.tex_offs_x = lo;
+	isct.size_x = hi - lo;
+	return isct;
+}
+
+// Uses interp0, claimed through interp_owner.h rather than saved/restored
 void __ram_func(sprite_asprite8)(uint8_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w) {
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
+	if (isct.size_x <= 0)
+		return;
+	isct = _clip_affine_to_texture(isct, sp, atrans);
 	if (isct.size_x <= 0)
 		return;
 	interp_hw_t *interp = interp0_hw;
 	_setup_interp_affine(interp, isct, atrans);
 	_setup_interp_pix_coordgen(interp, sp, 0);
 	// Now every read from POP_FULL will give us a new MODE7 lookup pointer for sp->img :)
-	sprite_ablit8_alpha_loop(scanbuf + MAX(0, sp->x), isct.size_x);
+	sprite_ablit8_alpha_loop(scanbuf + sp->x + isct.tex_offs_x, isct.size_x);
 }
 
 void __ram_func(sprite_asprite16)(uint16_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w) {
 	intersect_t isct = _get_sprite_intersect(sp, raster_y, raster_w);
+	if (isct.size_x <= 0)
+		return;
+	isct = _clip_affine_to_texture(isct, sp, atrans);
 	if (isct.size_x <= 0)
 		return;
 	interp_hw_t *interp = interp0_hw;
 	_setup_interp_affine(interp, isct, atrans);
 	_setup_interp_pix_coordgen(interp, sp, 1);
-	sprite_ablit16_alpha_loop(scanbuf + MAX(0, sp->x), isct.size_x);
+	sprite_ablit16_alpha_loop(scanbuf + sp->x + isct.tex_offs_x, isct.size_x);
+}
+
+// ----------------------------------------------------------------------------
+// Sprite lists
+
+void sprite_list_init(sprite_list_t *list, const sprite_t *sprites, uint16_t *order, uint n_sprites) {
+	list->sprites = sprites;
+	list->order = order;
+	list->n_sprites = n_sprites;
+	for (uint i = 0; i < n_sprites; ++i)
+		order[i] = i;
+}
+
+void sprite_list_set_count(sprite_list_t *list, uint n_sprites) {
+	uint16_t *order = list->order;
+	if (n_sprites < list->n_sprites) {
+		uint j = 0;
+		for (uint i = 0; i < list->n_sprites; ++i) {
+			if (order[i] < n_sprites)
+				order[j++] = order[i];
+		}
+	}
+	else {
+		for (uint i = list->n_sprites; i < n_sprites; ++i)
+			order[i] = i;
+	}
+	list->n_sprites = n_sprites;
+}
+
+void sprite_list_sort(sprite_list_t *list) {
+	const sprite_t *sprites = list->sprites;
+	uint16_t *order = list->order;
+	for (uint i = 1; i < list->n_sprites; ++i) {
+		uint16_t idx = order[i];
+		int y = sprites[idx].y;
+		uint j = i;
+		for (; j > 0 && sprites[order[j - 1]].y > y; --j)
+			order[j] = order[j - 1];
+		order[j] = idx;
+	}
+}
+
+void sprite_list_cursor_init(sprite_list_cursor_t *cursor, const sprite_list_t *list) {
+	cursor->list = list;
+	cursor->raster_y = -1;
+	cursor->next = 0;
+	cursor->n_active = 0;
+}
+
+// Bring the active set up to date for raster_y: retire sprites which ended
+// above it, then add any which have started, keeping the active set in array
+// order so the draw order doesn't depend on y.
+static void __ram_func(_sprite_list_advance)(sprite_list_cursor_t *cursor, uint raster_y) {
+	const sprite_list_t *list = cursor->list;
+	if ((int)raster_y <= cursor->raster_y)
+		sprite_list_cursor_init(cursor, list);
+	cursor->raster_y = raster_y;
+
+	uint n = 0;
+	for (uint i = 0; i < cursor->n_active; ++i) {
+		const sprite_t *sp = &list->sprites[cursor->active[i]];
+		if (sp->y + sp->height > (int)raster_y)
+			cursor->active[n++] = cursor->active[i];
+	}
+
+	for (; cursor->next < list->n_sprites; ++cursor->next) {
+		uint16_t idx = list->order[cursor->next];
+		const sprite_t *sp = &list->sprites[idx];
+		if (sp->y > (int)raster_y)
+			break;
+		// Skip sprites which ended on lines this cursor didn't visit
+		if (sp->y + sp->height <= (int)raster_y || n == SPRITE_LIST_MAX_ACTIVE)
+			continue;
+		uint j = n++;
+		for (; j > 0 && cursor->active[j - 1] > idx; --j)
+			cursor->active[j] = cursor->active[j - 1];
+		cursor->active[j] = idx;
+	}
+	cursor->n_active = n;
+}
+
+void __ram_func(sprite_list_sprite8)(uint8_t *scanbuf, sprite_list_cursor_t *cursor, uint raster_y, uint raster_w) {
+	_sprite_list_advance(cursor, raster_y);
+	for (uint i = 0; i < cursor->n_active; ++i)
+		sprite_sprite8(scanbuf, &cursor->list->sprites[cursor->active[i]], raster_y, raster_w);
+}
+
+void __ram_func(sprite_list_sprite16)(uint16_t *scanbuf, sprite_list_cursor_t *cursor, uint raster_y, uint raster_w) {
+	_sprite_list_advance(cursor, raster_y);
+	for (uint i = 0; i < cursor->n_active; ++i)
+		sprite_sprite16(scanbuf, &cursor->list->sprites[cursor->active[i]], raster_y, raster_w);
 }
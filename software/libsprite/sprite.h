@@ -4,17 +4,32 @@
 #include "pico/types.h"
 #include "affine_transform.h"
 
-// 3 words -- any bigger and we will need to pack the flags!
+// 4 words, with the flags packed. Width and height can be anything, and img
+// can point into a larger sheet, with stride giving the sheet's width.
+//
+// Opacity metadata, if present, is one word per row following the pixel data,
+// at img + stride * height pixels rounded up to a word boundary (see
+// scripts/packtiles --metadata).
+//
+// The affine functions need a power-of-two stride, since the interpolator
+// can't multiply. Power-of-two width and height tile the texture as before;
+// other sizes are clipped to the texture.
 typedef struct sprite {
 	int16_t x;
 	int16_t y;
 	const void *img;
-	uint8_t log_size; // always square
-	bool has_opacity_metadata;
-	bool hflip;
-	bool vflip;
+	uint16_t width;
+	uint16_t height;
+	uint16_t stride; // pixels from one row of img to the next, 0 means width
+	bool has_opacity_metadata : 1;
+	bool hflip : 1;
+	bool vflip : 1;
 } sprite_t;
 
+static inline uint sprite_stride(const sprite_t *sp) {
+	return sp->stride ? sp->stride : sp->width;
+}
+
 // ----------------------------------------------------------------------------
 // Functions from sprite.S
 
@@ -28,6 +43,12 @@ void sprite_blit8_alpha(uint8_t *dst, const uint8_t *src, uint len);
 void sprite_blit16(uint16_t *dst, const uint16_t *src, uint len);
 void sprite_blit16_alpha(uint16_t *dst, const uint16_t *src, uint len);
 
+// As above, but mirrored: dst[i] = src[len - 1 - i]
+void sprite_blit8_hflip(uint8_t *dst, const uint8_t *src, uint len);
+void sprite_blit8_alpha_hflip(uint8_t *dst, const uint8_t *src, uint len);
+void sprite_blit16_hflip(uint16_t *dst, const uint16_t *src, uint len);
+void sprite_blit16_alpha_hflip(uint16_t *dst, const uint16_t *src, uint len);
+
 // These are just inner loops, and require INTERP0 to be configured before calling:
 void sprite_ablit8_loop(uint8_t *dst, uint len);
 void sprite_ablit8_alpha_loop(uint8_t *dst, uint len);
@@ -45,4 +66,55 @@ void sprite_sprite16(uint16_t *scanbuf, const sprite_t *sp, uint raster_y, uint
 void sprite_asprite8(uint8_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w);
 void sprite_asprite16(uint16_t *scanbuf, const sprite_t *sp, const affine_transform_t atrans, uint raster_y, uint raster_w);
 
+// ----------------------------------------------------------------------------
+// Sprite lists
+
+// Maximum number of sprites on one scanline of a sprite list. Sprites which
+// start while this many are active are dropped, for all of their lines.
+#ifndef SPRITE_LIST_MAX_ACTIVE
+#define SPRITE_LIST_MAX_ACTIVE 64
+#endif
+
+// An array of sprites, with an index sorted by y. order has one entry per
+// sprite, and is owned by the caller. Sprites are drawn in array order, so
+// later sprites appear on top, same as calling sprite_sprite*() in a loop.
+typedef struct sprite_list {
+	const sprite_t *sprites;
+	uint16_t *order;
+	uint n_sprites;
+} sprite_list_t;
+
+// Where a scanline renderer has got to in a sprite list: the sprites which
+// intersect the current line, and the next sprite (in y order) to start.
+// Each core rendering from the same list needs its own cursor.
+typedef struct sprite_list_cursor {
+	const sprite_list_t *list;
+	int raster_y;
+	uint next;
+	uint n_active;
+	uint16_t active[SPRITE_LIST_MAX_ACTIVE];
+} sprite_list_cursor_t;
+
+void sprite_list_init(sprite_list_t *list, const sprite_t *sprites, uint16_t *order, uint n_sprites);
+
+// Change the number of sprites in use, i.e. sprites[0] to sprites[n_sprites
+// - 1]. New sprites are added to the end of order, and removed ones dropped
+// from it, so call sprite_list_sort() afterwards. order must have room for
+// n_sprites entries. Don't write list->n_sprites directly, as order would no
+// longer hold each sprite exactly once.
+void sprite_list_set_count(sprite_list_t *list, uint n_sprites);
+
+// Call once per frame, after moving sprites and before rendering. Insertion
+// sort, so cheap when sprites have only moved a little since the last frame.
+void sprite_list_sort(sprite_list_t *list);
+
+void sprite_list_cursor_init(sprite_list_cursor_t *cursor, const sprite_list_t *list);
+
+// Render all sprites in the list which intersect raster_y. raster_y must
+// increase from one call to the next within a frame (lines may be skipped),
+// and going back up the screen restarts the cursor at the top of the frame.
+// Per-line cost depends on the sprites on the line, not on the list length.
+void sprite_list_sprite8(uint8_t *scanbuf, sprite_list_cursor_t *cursor, uint raster_y, uint raster_w);
+void sprite_list_sprite16(uint16_t *scanbuf, sprite_list_cursor_t *cursor, uint raster_y, uint raster_w);
+
 #endif
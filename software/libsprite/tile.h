@@ -39,13 +39,25 @@ typedef struct tilebg {
 typedef void (*tile16_loop_t)(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
 typedef void (*tile8_loop_t)(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
 
+// Alpha variants skip pixels with the alpha bit clear (bit 5, as in the
+// sprite blitters), so a tilebg can be layered over another.
 void tile16_16px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
 void tile16_16px_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+void tile16_8px_alpha_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+void tile16_8px_loop(uint16_t *dst, const uint16_t *tileset, uint x0, uint x1);
+
+void tile8_16px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_16px_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_8px_alpha_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
+void tile8_8px_loop(uint8_t *dst, const uint8_t *tileset, uint x0, uint x1);
 
 // ----------------------------------------------------------------------------
 // Functions from tile.c
 
+// Render one scanline of a tilebg. bg->fill_loop must be one of the tile16_*
+// loops for tile16(), or tile8_* for tile8(), matching bg->tilesize.
 void tile16(uint16_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w);
+void tile8(uint8_t *scanbuf, const tilebg_t *bg, uint raster_y, uint raster_w);
 
 
 
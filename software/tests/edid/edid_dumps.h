@@ -0,0 +1,59 @@
+#ifndef _EDID_DUMPS_H
+#define _EDID_DUMPS_H
+
+#include "pico/types.h"
+
+// EDID blocks for test_edid.c, laid out the way typical displays report
+// themselves. The detailed timing descriptors are the standard byte patterns
+// for the CEA-861 formats, as found in most monitors and TVs. Checksums are
+// valid; the tests corrupt copies to check the failure paths.
+
+// EDID 1.3 desktop monitor, base block only:
+// - Preferred detailed timing 1920x1080p60, 148.5 MHz, +hsync +vsync
+// - Established timings 720x400@70, 640x480@60/75, 800x600@60/75,
+//   1024x768@60/75, 1280x1024@75
+// - Standard timings 1280x1024@60 (5:4), 1440x900@60 and 1680x1050@60
+//   (16:10), 1920x1080@60 (16:9)
+// - Serial number, name "PDV 1080P", and range limits 56-76 Hz, 30-83 kHz,
+//   170 MHz
+static const uint8_t edid_monitor_1080p[128] = {
+	0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x40, 0x96, 0x34, 0x12, 0x00, 0x00, 0x00, 0x00,
+	0x0c, 0x19, 0x01, 0x03, 0x80, 0x30, 0x1b, 0x78, 0xea, 0xee, 0x91, 0xa3, 0x54, 0x4c, 0x99, 0x26,
+	0x0f, 0x50, 0x54, 0xa5, 0x4b, 0x00, 0x81, 0x80, 0x95, 0x00, 0xb3, 0x00, 0xd1, 0xc0, 0x01, 0x01,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x3a, 0x80, 0x18, 0x71, 0x38, 0x2d, 0x40, 0x58, 0x2c,
+	0x45, 0x00, 0xe0, 0x0e, 0x11, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0xff, 0x00, 0x50, 0x44, 0x56,
+	0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x31, 0x0a, 0x20, 0x20, 0x00, 0x00, 0x00, 0xfc, 0x00, 0x50,
+	0x44, 0x56, 0x20, 0x31, 0x30, 0x38, 0x30, 0x50, 0x0a, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0xfd,
+	0x00, 0x38, 0x4c, 0x1e, 0x53, 0x11, 0x00, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0xe4,
+};
+
+// EDID 1.3 TV, with a CEA-861 extension block:
+// - Base block: detailed timings 1920x1080p60 (preferred) and 1280x720p60,
+//   established timings 640x480@60, 800x600@60, 1024x768@60, standard
+//   timings 1280x720@60 and 1920x1080@60, name "PDV TV", and range limits
+//   23-61 Hz, 15-68 kHz, 150 MHz
+// - Extension: short video descriptors for VICs 16 (native), 4, 3, 1, 5, 31,
+//   19, 20 and 2, of which 5 and 20 are 1080i formats libdvi can't generate.
+//   Audio and speaker allocation blocks, and an HDMI vendor-specific block.
+//   Detailed timings 1920x1080i60 (74.25 MHz) and 720x480p60 (27 MHz,
+//   -hsync -vsync).
+static const uint8_t edid_tv_cea[256] = {
+	0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x40, 0x96, 0x78, 0x56, 0x00, 0x00, 0x00, 0x00,
+	0x1e, 0x1c, 0x01, 0x03, 0x80, 0xa0, 0x5a, 0x78, 0x0a, 0xee, 0x91, 0xa3, 0x54, 0x4c, 0x99, 0x26,
+	0x0f, 0x50, 0x54, 0x21, 0x08, 0x00, 0x81, 0xc0, 0xd1, 0xc0, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x3a, 0x80, 0x18, 0x71, 0x38, 0x2d, 0x40, 0x58, 0x2c,
+	0x45, 0x00, 0x40, 0x84, 0x63, 0x00, 0x00, 0x1e, 0x01, 0x1d, 0x00, 0x72, 0x51, 0xd0, 0x1e, 0x20,
+	0x6e, 0x28, 0x55, 0x00, 0x40, 0x84, 0x63, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0xfc, 0x00, 0x50,
+	0x44, 0x56, 0x20, 0x54, 0x56, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0xfd,
+	0x00, 0x17, 0x3d, 0x0f, 0x44, 0x0f, 0x00, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x01, 0xde,
+	0x02, 0x03, 0x1c, 0xf1, 0x49, 0x90, 0x04, 0x03, 0x01, 0x05, 0x1f, 0x13, 0x14, 0x02, 0x23, 0x09,
+	0x07, 0x07, 0x83, 0x01, 0x00, 0x00, 0x65, 0x03, 0x0c, 0x00, 0x10, 0x00, 0x01, 0x1d, 0x80, 0x18,
+	0x71, 0x1c, 0x16, 0x20, 0x58, 0x2c, 0x25, 0x00, 0x40, 0x84, 0x63, 0x00, 0x00, 0x9e, 0x8c, 0x0a,
+	0xd0, 0x8a, 0x20, 0xe0, 0x2d, 0x10, 0x10, 0x3e, 0x96, 0x00, 0x40, 0x84, 0x63, 0x00, 0x00, 0x18,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x47,
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include <stdio.h>
+#include <string.h>
+#include "dvi_edid.h"
+#include "edid_dumps.h"
+
+// Host-side tests for the EDID parser and mode selector, against the dumps in
+// edid_dumps.h. Prints each failed check, and exits nonzero if there were any.
+
+static uint n_failed;
+
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: %s: CHECK(%s) failed\n", __FILE__, __LINE__, __func__, #cond); \
+		++n_failed; \
+	} \
+} while (0)
+
+static struct dvi_edid edid;
+
+static const struct dvi_edid_mode *find_mode(uint source, uint h, uint v, uint refresh_hz) {
+	for (uint i = 0; i < edid.n_modes; ++i) {
+		const struct dvi_edid_mode *m = &edid.modes[i];
+		if (m->source == source && m->h_active == h && m->v_active == v && m->refresh_hz == refresh_hz)
+			return m;
+	}
+	return NULL;
+}
+
+static uint count_source(uint source) {
+	uint n = 0;
+	for (uint i = 0; i < edid.n_modes; ++i)
+		n += edid.modes[i].source == source;
+	return n;
+}
+
+static void check_timing(const struct dvi_timing *t, bool h_pol, uint h_fp, uint h_sync, uint h_bp, uint h_active,
+		bool v_pol, uint v_fp, uint v_sync, uint v_bp, uint v_active) {
+	CHECK(t->h_sync_polarity == h_pol);
+	CHECK(t->h_front_porch == h_fp);
+	CHECK(t->h_sync_width == h_sync);
+	CHECK(t->h_back_porch == h_bp);
+	CHECK(t->h_active_pixels == h_active);
+	CHECK(t->v_sync_polarity == v_pol);
+	CHECK(t->v_front_porch == v_fp);
+	CHECK(t->v_sync_width == v_sync);
+	CHECK(t->v_back_porch == v_bp);
+	CHECK(t->v_active_lines == v_active);
+}
+
+// ----------------------------------------------------------------------------
+// Parsing
+
+static void test_monitor_parse(void) {
+	CHECK(dvi_edid_block_valid(edid_monitor_1080p, true));
+	CHECK(dvi_edid_parse(edid_monitor_1080p, 1, &edid));
+	CHECK(edid.version == 1 && edid.revision == 3);
+	CHECK(!strcmp(edid.mfg_id, "PDV"));
+	CHECK(edid.product_code == 0x1234);
+	CHECK(!strcmp(edid.name, "PDV 1080P"));
+	CHECK(edid.digital);
+	CHECK(!edid.hdmi);
+	CHECK(edid.has_range_limits);
+	CHECK(edid.min_v_hz == 56 && edid.max_v_hz == 76);
+	CHECK(edid.min_h_khz == 30 && edid.max_h_khz == 83);
+	CHECK(edid.max_pixel_khz == 170000);
+	CHECK(!edid.cvt_rb);
+	CHECK(edid.n_modes == 13);
+
+	// DTD comes first, and is the preferred mode
+	const struct dvi_edid_mode *m = &edid.modes[0];
+	CHECK(m->source == DVI_EDID_DETAILED);
+	CHECK(m->preferred && !m->interlaced);
+	CHECK(m->h_active == 1920 && m->v_active == 1080 && m->refresh_hz == 60);
+	check_timing(&m->detailed, true, 88, 44, 148, 1920, true, 4, 5, 36, 1080);
+	CHECK(!m->detailed.interlaced);
+	CHECK(m->detailed.bit_clk_khz == 1485000);
+
+	CHECK(count_source(DVI_EDID_ESTABLISHED) == 8);
+	CHECK(find_mode(DVI_EDID_ESTABLISHED, 720, 400, 70));
+	CHECK(find_mode(DVI_EDID_ESTABLISHED, 640, 480, 60));
+	CHECK(find_mode(DVI_EDID_ESTABLISHED, 1280, 1024, 75));
+	CHECK(!find_mode(DVI_EDID_ESTABLISHED, 800, 600, 56));
+
+	// One of each aspect ratio except 4:3
+	CHECK(count_source(DVI_EDID_STANDARD) == 4);
+	CHECK(find_mode(DVI_EDID_STANDARD, 1280, 1024, 60));
+	CHECK(find_mode(DVI_EDID_STANDARD, 1440, 900, 60));
+	CHECK(find_mode(DVI_EDID_STANDARD, 1680, 1050, 60));
+	CHECK(find_mode(DVI_EDID_STANDARD, 1920, 1080, 60));
+}
+
+static void test_tv_parse(void) {
+	CHECK(dvi_edid_block_valid(edid_tv_cea, true));
+	CHECK(dvi_edid_block_valid(edid_tv_cea + DVI_EDID_BLOCK_SIZE, false));
+	CHECK(dvi_edid_parse(edid_tv_cea, 2, &edid));
+	CHECK(!strcmp(edid.name, "PDV TV"));
+	CHECK(edid.hdmi);
+	CHECK(edid.min_h_khz == 15 && edid.max_pixel_khz == 150000);
+	CHECK(edid.n_modes == 16);
+
+	// Base block DTDs: only the first is preferred
+	CHECK(edid.modes[0].source == DVI_EDID_DETAILED && edid.modes[0].preferred);
+	CHECK(edid.modes[0].h_active == 1920 && edid.modes[0].v_active == 1080);
+	const struct dvi_edid_mode *m = &edid.modes[1];
+	CHECK(m->source == DVI_EDID_DETAILED && !m->preferred);
+	CHECK(m->h_active == 1280 && m->v_active == 720 && m->refresh_hz == 60);
+	check_timing(&m->detailed, true, 110, 40, 220, 1280, true, 5, 5, 20, 720);
+	CHECK(m->detailed.bit_clk_khz == 742500);
+
+	// SVDs, with the native flag stripped from VIC 16, and the 1080i VICs
+	// (5, 20) skipped. VIC 3 is listed with its own number.
+	CHECK(count_source(DVI_EDID_CEA_VIC) == 7);
+	static const uint8_t vics[] = {16, 4, 3, 1, 31, 19, 2};
+	uint j = 0;
+	for (uint i = 0; i < edid.n_modes; ++i) {
+		if (edid.modes[i].source != DVI_EDID_CEA_VIC)
+			continue;
+		CHECK(j < count_of(vics) && edid.modes[i].vic == vics[j]);
+		CHECK(!edid.modes[i].preferred && !edid.modes[i].interlaced);
+		++j;
+	}
+	m = find_mode(DVI_EDID_CEA_VIC, 1920, 1080, 50);
+	CHECK(m && m->vic == 31);
+	m = find_mode(DVI_EDID_CEA_VIC, 720, 480, 60);
+	CHECK(m && m->vic == 3);
+
+	// Extension DTDs: the interlaced one is listed at frame height, with the
+	// field timing in detailed, and the refresh being the field rate
+	m = &edid.modes[14];
+	CHECK(m->source == DVI_EDID_DETAILED && m->interlaced && !m->preferred);
+	CHECK(m->h_active == 1920 && m->v_active == 1080 && m->refresh_hz == 60);
+	check_timing(&m->detailed, true, 88, 44, 148, 1920, true, 2, 5, 15, 540);
+	CHECK(m->detailed.interlaced);
+	CHECK(m->detailed.bit_clk_khz == 742500);
+	m = &edid.modes[15];
+	CHECK(m->source == DVI_EDID_DETAILED && !m->interlaced);
+	CHECK(m->h_active == 720 && m->v_active == 480 && m->refresh_hz == 60);
+	check_timing(&m->detailed, false, 16, 62, 60, 720, false, 9, 6, 30, 480);
+	CHECK(m->detailed.bit_clk_khz == 270000);
+}
+
+// ----------------------------------------------------------------------------
+// Checksum and header failures
+
+static void test_bad_base_block(void) {
+	uint8_t block[DVI_EDID_BLOCK_SIZE];
+
+	memcpy(block, edid_monitor_1080p, sizeof(block));
+	block[0x36] ^= 0x01;
+	CHECK(!dvi_edid_block_valid(block, true));
+	CHECK(!dvi_edid_parse(block, 1, &edid));
+	CHECK(edid.n_modes == 0);
+
+	// Fixing up the checksum makes it valid again
+	block[127] -= 0x01;
+	CHECK(dvi_edid_block_valid(block, true));
+
+	// Header is only required of the base block
+	memcpy(block, edid_monitor_1080p, sizeof(block));
+	block[1] = 0x00;
+	block[127] += 0xff;
+	CHECK(!dvi_edid_block_valid(block, true));
+	CHECK(dvi_edid_block_valid(block, false));
+	CHECK(!dvi_edid_parse(block, 1, &edid));
+
+	CHECK(!dvi_edid_parse(edid_monitor_1080p, 0, &edid));
+}
+
+static void test_bad_extension_block(void) {
+	uint8_t blocks[2 * DVI_EDID_BLOCK_SIZE];
+	memcpy(blocks, edid_tv_cea, sizeof(blocks));
+	blocks[DVI_EDID_BLOCK_SIZE + 5] ^= 0x01;
+	CHECK(!dvi_edid_block_valid(blocks + DVI_EDID_BLOCK_SIZE, false));
+
+	// The base block still parses, but nothing comes from the extension
+	CHECK(dvi_edid_parse(blocks, 2, &edid));
+	CHECK(!edid.hdmi);
+	CHECK(edid.n_modes == 7);
+	CHECK(count_source(DVI_EDID_CEA_VIC) == 0);
+	CHECK(count_source(DVI_EDID_DETAILED) == 2);
+
+	// Same as if the extension wasn't read at all
+	CHECK(dvi_edid_parse(edid_tv_cea, 1, &edid));
+	CHECK(edid.n_modes == 7);
+}
+
+// ----------------------------------------------------------------------------
+// Reading through a transport
+
+struct fake_ddc {
+	const uint8_t *data;
+	uint n_blocks;
+	uint n_reads;
+};
+
+static bool fake_ddc_read(void *ctx, uint segment, uint offset, uint8_t *buf, uint len) {
+	struct fake_ddc *ddc = ctx;
+	uint start = segment * 2 * DVI_EDID_BLOCK_SIZE + offset;
+	++ddc->n_reads;
+	if (start + len > ddc->n_blocks * DVI_EDID_BLOCK_SIZE)
+		return false;
+	memcpy(buf, ddc->data + start, len);
+	return true;
+}
+
+static void test_read(void) {
+	uint8_t buf[4 * DVI_EDID_BLOCK_SIZE];
+	struct fake_ddc fake = {.data = edid_tv_cea, .n_blocks = 2};
+	struct dvi_edid_transport ddc = {.read = fake_ddc_read, .ctx = &fake};
+
+	CHECK(dvi_edid_read(&ddc, buf, 4) == 2);
+	CHECK(fake.n_reads == 2);
+	CHECK(!memcmp(buf, edid_tv_cea, sizeof(edid_tv_cea)));
+
+	fake.n_reads = 0;
+	CHECK(dvi_edid_read(&ddc, buf, 1) == 1);
+	CHECK(fake.n_reads == 1);
+
+	// Bad extension: stop at the base block
+	uint8_t corrupt[2 * DVI_EDID_BLOCK_SIZE];
+	memcpy(corrupt, edid_tv_cea, sizeof(corrupt));
+	corrupt[DVI_EDID_BLOCK_SIZE + 127] ^= 0x80;
+	fake.data = corrupt;
+	CHECK(dvi_edid_read(&ddc, buf, 4) == 1);
+
+	// Bad base block: nothing
+	corrupt[0x40] ^= 0x80;
+	CHECK(dvi_edid_read(&ddc, buf, 4) == 0);
+
+	// Display with no EDID at all
+	fake.n_blocks = 0;
+	CHECK(dvi_edid_read(&ddc, buf, 4) == 0);
+}
+
+// ----------------------------------------------------------------------------
+// Mode selection
+
+static void test_monitor_select(void) {
+	struct dvi_timing t;
+	CHECK(dvi_edid_parse(edid_monitor_1080p, 1, &edid));
+
+	// CVT 640x480p60 has the lowest clock, but its 29.7 kHz line rate is
+	// below the monitor's range, so the CEA timing is used instead
+	CHECK(dvi_edid_select_timing(&edid, 640, 480, DVI_TIMING_METHODS_ALL, 320000, &t));
+	check_timing(&t, false, 16, 96, 48, 640, false, 10, 2, 33, 480);
+	CHECK(t.bit_clk_khz == 252000);
+	CHECK(dvi_edid_select_timing(&edid, 0, 0, DVI_TIMING_METHODS_ALL, 320000, &t));
+	CHECK(t.h_active_pixels == 640 && t.bit_clk_khz == 252000);
+
+	// With only CVT allowed, the fastest in-range 640x480 is 75 Hz
+	CHECK(dvi_edid_select_timing(&edid, 640, 480, 1u << DVI_TIMING_CVT, 320000, &t));
+	CHECK(t.bit_clk_khz == 307200);
+	CHECK(!dvi_edid_select_timing(&edid, 640, 480, 1u << DVI_TIMING_CVT, 300000, &t));
+
+	// The DTD, snapped to the PLL
+	CHECK(dvi_edid_select_timing(&edid, 1920, 1080, DVI_TIMING_METHODS_ALL, 1500000, &t));
+	check_timing(&t, true, 88, 44, 148, 1920, true, 4, 5, 36, 1080);
+	CHECK(t.bit_clk_khz == 1488000);
+
+	CHECK(!dvi_edid_select_timing(&edid, 1280, 720, DVI_TIMING_METHODS_ALL, 1500000, &t));
+	CHECK(!dvi_edid_select_timing(&edid, 0, 0, DVI_TIMING_METHODS_ALL, 200000, &t));
+}
+
+static void test_tv_select(void) {
+	struct dvi_timing t;
+	CHECK(dvi_edid_parse(edid_tv_cea, 2, &edid));
+
+	// The TV's range goes down to 15 kHz, so CVT 640x480p60 is allowed
+	CHECK(dvi_edid_select_timing(&edid, 640, 480, DVI_TIMING_METHODS_ALL, 320000, &t));
+	CHECK(t.bit_clk_khz == 237600);
+	CHECK(dvi_edid_select_timing(&edid, 640, 480, 1u << DVI_TIMING_CEA, 320000, &t));
+	CHECK(t.bit_clk_khz == 252000);
+
+	// 720x480p60 from the VIC (27.027 MHz) and from the DTD (27 MHz)
+	CHECK(dvi_edid_select_timing(&edid, 720, 480, DVI_TIMING_METHODS_ALL, 320000, &t));
+	check_timing(&t, false, 16, 62, 60, 720, false, 9, 6, 30, 480);
+	CHECK(t.bit_clk_khz == 270000);
+
+	CHECK(dvi_edid_select_timing(&edid, 1280, 720, DVI_TIMING_METHODS_ALL, 800000, &t));
+	check_timing(&t, true, 110, 40, 220, 1280, true, 5, 5, 20, 720);
+	CHECK(t.bit_clk_khz == 744000);
+
+	// Interlaced modes only come from DTDs, and are cheaper than 1080p
+	CHECK(dvi_edid_select_timing(&edid, 1920, 1080, DVI_TIMING_METHODS_ALL, 1500000, &t));
+	CHECK(t.interlaced);
+	CHECK(t.v_active_lines == 540);
+	CHECK(t.bit_clk_khz == 744000);
+}
+
+int main(void) {
+	test_monitor_parse();
+	test_tv_parse();
+	test_bad_base_block();
+	test_bad_extension_block();
+	test_read();
+	test_monitor_select();
+	test_tv_select();
+	if (n_failed) {
+		printf("%u checks failed\n", n_failed);
+		return 1;
+	}
+	printf("All EDID tests passed\n");
+	return 0;
+}
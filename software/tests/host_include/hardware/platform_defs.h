@@ -0,0 +1,6 @@
+#ifndef _HARDWARE_PLATFORM_DEFS_H
+#define _HARDWARE_PLATFORM_DEFS_H
+
+#include "pico.h"
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef _PICO_H
+#define _PICO_H
+
+// Just enough of the Pico SDK for the parts of libdvi which build for the
+// host (PICO_NO_HARDWARE) to compile with the host compiler.
+
+#include "pico/types.h"
+#include "pico/config.h"
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#endif
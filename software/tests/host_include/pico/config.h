@@ -0,0 +1,12 @@
+#ifndef _PICO_CONFIG_H
+#define _PICO_CONFIG_H
+
+#ifndef PICO_NO_HARDWARE
+#define PICO_NO_HARDWARE 1
+#endif
+
+#ifndef PICO_RP2040
+#define PICO_RP2040 1
+#endif
+
+#endif